@@ -0,0 +1,100 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "activation.h"
+#include "util.h"
+
+// The ground truth, in double precision with libm.
+float accurate_sigmoid(float x) {
+    double xd = x;
+    return xd >= 0 ? 1 / (1 + exp(-xd)) : exp(xd) / (1 + exp(xd));
+}
+float accurate_tanh(float x) { return tanh(double(x)); }
+float accurate_softplus(float x) {
+    double xd = x;
+    return std::max(xd, 0.) + log1p(exp(-std::abs(xd)));
+}
+float accurate_gelu_tanh(float x) {
+    double xd = x;
+    if (std::isinf(xd)) {
+        return xd > 0 ? xd : -0.;
+    }
+    // 0.5 * (1 + tanh(u)) cancels in double for negative x, so use the
+    // equivalent 1/(1 + exp(-2u)).
+    double u = sqrt(2 / M_PI) * (xd + 0.044715 * xd * xd * xd);
+    return xd / (1 + exp(-2 * u));
+}
+
+// What the callers do today: call expf and do the arithmetic in float.
+float __attribute__((noinline)) libm_sigmoid(float x) { return 1 / (1 + expf(-x)); }
+float __attribute__((noinline)) libm_tanh(float x) {
+    float e = expf(2 * x);
+    return (e - 1) / (e + 1);
+}
+float __attribute__((noinline)) libm_softplus(float x) { return log1pf(expf(x)); }
+float __attribute__((noinline)) libm_gelu_tanh(float x) {
+    float u = 0.7978845608f * (x + 0.044715f * x * x * x);
+    float e = expf(2 * u);
+    return 0.5f * x * (1 + (e - 1) / (e + 1));
+}
+
+void check() {
+    float inf = INFINITY;
+    assert(my_sigmoid(0) == 0.5f);
+    assert(my_sigmoid(inf) == 1 && my_sigmoid(-inf) == 0);
+    assert(my_sigmoid(100) == 1 && my_sigmoid(-200) == 0);
+    assert(my_sigmoid(-100) > 0);
+    assert(std::isnan(my_sigmoid(NAN)));
+
+    assert(my_tanh(0) == 0 && std::signbit(my_tanh(-0.f)));
+    assert(my_tanh(inf) == 1 && my_tanh(-inf) == -1);
+    assert(my_tanh(1e-30f) == 1e-30f);
+    assert(std::isnan(my_tanh(NAN)));
+
+    assert(my_softplus(0) == float(log(2.)));
+    assert(my_softplus(inf) == inf && my_softplus(-inf) == 0);
+    assert(my_softplus(1e30f) == 1e30f && my_softplus(-1e30f) == 0);
+    assert(my_softplus(-100) > 0);
+    assert(std::isnan(my_softplus(NAN)));
+
+    assert(my_gelu_tanh(0) == 0);
+    assert(my_gelu_tanh(inf) == inf && my_gelu_tanh(-inf) == 0);
+    assert(my_gelu_tanh(1e30f) == 1e30f && my_gelu_tanh(-1e30f) == 0);
+    assert(std::isnan(my_gelu_tanh(NAN)));
+
+    // The batch kernels match the scalar ones.
+    std::vector<float> in = generate_test_vector<float>(-20, 20, 1000);
+    std::vector<float> out(in.size());
+    my_gelu_tanh(in.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); i++) {
+        assert(out[i] == my_gelu_tanh(in[i]));
+    }
+}
+
+int main(int argc, char **argv) {
+    check();
+    print_ulp_deltas(my_sigmoid, accurate_sigmoid);
+    print_ulp_deltas(my_tanh, accurate_tanh);
+    print_ulp_deltas(my_softplus, accurate_softplus);
+    print_ulp_deltas(my_gelu_tanh, accurate_gelu_tanh);
+
+    std::vector<float> iv = generate_test_vector<float>(-8., 8., 10000);
+    bench("my_sigmoid    ", my_sigmoid, iv);
+    bench("libm_sigmoid  ", libm_sigmoid, iv);
+    bench("my_tanh       ", my_tanh, iv);
+    bench("libm_tanh     ", libm_tanh, iv);
+    bench("my_softplus   ", my_softplus, iv);
+    bench("libm_softplus ", libm_softplus, iv);
+    bench("my_gelu_tanh  ", my_gelu_tanh, iv);
+    bench("libm_gelu_tanh", libm_gelu_tanh, iv);
+    bench_batch("batch_sigmoid  ", my_sigmoid, iv);
+    bench_batch("batch_tanh     ", my_tanh, iv);
+    bench_batch("batch_softplus ", my_softplus, iv);
+    bench_batch("batch_gelu_tanh", my_gelu_tanh, iv);
+    return 0;
+}
@@ -0,0 +1,124 @@
+#ifndef ACTIVATION_H
+#define ACTIVATION_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "exp_accurate.h"
+#include "logaddexp.h"
+#include "util.h"
+
+// Activation functions on top of the range reduction of my_exp. The kernels
+// compute in double, where exp_neg_reduced has a relative error near 2^-50,
+// and round once to float. The exhaustive checks in activation.cc show that
+// all the results are within 1 ULP of the double precision reference.
+
+/// Compute 1/(1+exp(-z)) in double. Only exp(-|z|) is evaluated, so nothing
+/// overflows, and there is no cancellation for negative z.
+inline double sigmoid_double(double z) {
+    // exp(-709) is near the smallest normal double. Below that the result
+    // does not change the float results of the callers.
+    double d = std::min(std::abs(z), 709.);
+    double e = exp_neg_reduced(d);
+    return z >= 0 ? 1 / (1 + e) : e / (1 + e);
+}
+
+/// Compute the sigmoid 1/(1+exp(-x)). The error is below 1 ULP.
+inline float sigmoid_impl(float x) {
+    // Handle NaN and the infinities.
+    if (is_nan(x)) {
+        return std::isnan(x) ? x : (x > 0 ? 1 : 0);
+    }
+    return sigmoid_double(x);
+}
+
+/// Compute tanh(x) = (1 - exp(-2|x|))/(1 + exp(-2|x|)), with the sign of x.
+/// The error is below 1 ULP.
+inline float tanh_impl(float x) {
+    if (is_nan(x)) {
+        return std::isnan(x) ? x : (x > 0 ? 1 : -1);
+    }
+    double d = std::abs(double(x));
+    double r;
+    if (d < 0.0625) {
+        // The subtraction cancels for small inputs. Use the Taylor expansion
+        // tanh(x) = x - x^3/3 + 2x^5/15 - 17x^7/315 + 62x^9/2835, where the
+        // relative error is below 2^-45.
+        double x2 = d * d;
+        r = d * (1 + x2 * (-1. / 3 + x2 * (2. / 15 + x2 * (-17. / 315 + x2 * (62. / 2835)))));
+    } else if (d >= 10) {
+        // 1 - tanh(10) = 4.1e-9 is below half a float ULP of 1 (2^-25), so
+        // the result rounds to one.
+        r = 1;
+    } else {
+        double e = exp_neg_reduced(2 * d);
+        r = (1 - e) / (1 + e);
+    }
+    return std::copysign(r, double(x));
+}
+
+/// Compute softplus(x) = log(1 + exp(x)) = max(x, 0) + log1p(exp(-|x|)). The
+/// error is below 1 ULP.
+inline float softplus_impl(float x) {
+    if (is_nan(x)) {
+        return std::isnan(x) ? x : (x > 0 ? x : 0);
+    }
+    double d = std::abs(double(x));
+    // The correction term is below half of the smallest denormal, or below
+    // half an ULP of x.
+    if (d >= 104) {
+        return x > 0 ? x : 0;
+    }
+    return std::max(double(x), 0.) + log1p_exp_neg(d);
+}
+
+/// Compute the tanh approximation of GELU:
+///   0.5x(1 + tanh(sqrt(2/pi)(x + 0.044715x^3)))
+/// With 1 + tanh(u) = 2 * sigmoid(2u) this is x * sigmoid(2u), which does not
+/// cancel for negative x. The error is below 1 ULP.
+inline float gelu_tanh_impl(float x) {
+    if (is_nan(x)) {
+        return std::isnan(x) ? x : (x > 0 ? x : -0.f);
+    }
+    double xd = x;
+    // 2 * sqrt(2/pi).
+    double u2 = 1.5957691216057308 * (xd + 0.044715 * xd * xd * xd);
+    return xd * sigmoid_double(u2);
+}
+
+KERNEL_API float my_sigmoid(float x) { return sigmoid_impl(x); }
+KERNEL_API float my_tanh(float x) { return tanh_impl(x); }
+KERNEL_API float my_softplus(float x) { return softplus_impl(x); }
+KERNEL_API float my_gelu_tanh(float x) { return gelu_tanh_impl(x); }
+
+/// Compute \p out[i] = sigmoid(\p in[i]) for \p n elements.
+KERNEL_API void my_sigmoid(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = sigmoid_impl(in[i]);
+    }
+}
+
+/// Compute \p out[i] = tanh(\p in[i]) for \p n elements.
+KERNEL_API void my_tanh(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = tanh_impl(in[i]);
+    }
+}
+
+/// Compute \p out[i] = softplus(\p in[i]) for \p n elements.
+KERNEL_API void my_softplus(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = softplus_impl(in[i]);
+    }
+}
+
+/// Compute \p out[i] = gelu_tanh(\p in[i]) for \p n elements.
+KERNEL_API void my_gelu_tanh(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = gelu_tanh_impl(in[i]);
+    }
+}
+
+#endif // ACTIVATION_H
@@ -0,0 +1,105 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <math.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "correctly_rounded.h"
+#include "util.h"
+
+// The ground truth is correctly rounded with the same strategy, but on top of
+// the libm double functions, which are independent of our kernels, with an
+// error below 2^-52.
+float reference_log(float x) {
+    double r = log(double(x));
+    if (!std::isfinite(r) || float_rounding_is_safe(r, std::abs(r) * 0x1p-50)) {
+        return float(r);
+    }
+    return float(logq(__float128(x)));
+}
+float reference_exp(float x) {
+    double r = exp(double(x));
+    if (!std::isfinite(r) || float_rounding_is_safe(r, r * 0x1p-50)) {
+        return float(r);
+    }
+    return float(expq(__float128(x)));
+}
+
+float libm_logf(float x) { return logf(x); }
+float libm_expf(float x) { return expf(x); }
+
+void check() {
+    assert(cr_log(1) == 0 && cr_exp(0) == 1);
+    assert(cr_log(0) == -INFINITY && std::isnan(cr_log(-1)));
+    assert(cr_exp(100) == INFINITY && cr_exp(-110) == 0);
+    assert(std::isnan(cr_log(NAN)) && std::isnan(cr_exp(NAN)));
+
+    // The midpoint between 1 and the next float is not safe, the values
+    // around it are.
+    assert(!float_rounding_is_safe(1 + 0x1p-24, 0x1p-60));
+    assert(float_rounding_is_safe(1 + 0x1p-24 + 0x1p-40, 0x1p-50));
+    assert(float_rounding_is_safe(1 + 0x1p-24 - 0x1p-40, 0x1p-50));
+    // The same for the denormals, where the grid is 2^-149.
+    assert(!float_rounding_is_safe(0x1.8p-149, 0x1p-170));
+    assert(float_rounding_is_safe(0x1.7p-149, 0x1p-170));
+
+    // Compare to __float128 directly, without the double fast path of the
+    // reference.
+    std::mt19937 mt(42);
+    for (int i = 0; i < 100000; i++) {
+        float x = bit_cast<float, uint32_t>(mt() & 0x7fffffff);
+        if (std::isfinite(x) && x != 0) {
+            assert(cr_log(x) == float(logq(__float128(x))));
+        }
+        float y = -104 + 193 * (mt() / 4294967296.);
+        assert(cr_exp(y) == float(expq(__float128(y))));
+    }
+}
+
+/// @return the inputs in [first .. last) that take the slow path.
+std::vector<float> collect_slow_path(bool (*fast)(float, float &), uint64_t first,
+                                     uint64_t last) {
+    std::vector<float> res;
+    for (uint64_t i = first; i < last; i++) {
+        float x = bit_cast<float, unsigned>(unsigned(i));
+        float r;
+        if (!fast(x, r)) {
+            res.push_back(x);
+        }
+    }
+    return res;
+}
+
+int main(int argc, char **argv) {
+    check();
+    print_ulp_deltas(cr_log, reference_log);
+    print_ulp_deltas(cr_exp, reference_exp);
+
+    // All the positive floats for log, and all the non-trivial inputs of exp:
+    // [0 .. 89) and [-0 .. -104).
+    std::vector<float> log_slow = collect_slow_path(cr_log_fast, 0, 0x7f800000);
+    std::vector<float> exp_slow = collect_slow_path(cr_exp_fast, 0, 0x42b20000);
+    std::vector<float> exp_slow_neg = collect_slow_path(cr_exp_fast, 0x80000000, 0xc2d00000);
+    exp_slow.insert(exp_slow.end(), exp_slow_neg.begin(), exp_slow_neg.end());
+    printf("\nSlow path: log = %zu of %lu inputs, exp = %zu of %lu inputs\n", log_slow.size(),
+           uint64_t(0x7f800000), exp_slow.size(), uint64_t(0x42b20000) + 0x42d00000);
+
+    std::vector<float> iv = generate_test_vector<float>(0.01, 100, 10000);
+    std::vector<float> ev = generate_test_vector<float>(-20, 20, 10000);
+    bench("cr_log   ", cr_log, iv);
+    bench("my_log   ", my_log, iv);
+    bench("libm_logf", libm_logf, iv);
+    bench("cr_exp   ", cr_exp, ev);
+    bench("my_exp   ", my_exp, ev);
+    bench("libm_expf", libm_expf, ev);
+
+    // The cost of the slow path, on the inputs that take it.
+    bench("cr_log_slow_path", cr_log, log_slow);
+    bench("my_log_slow_path", my_log, log_slow);
+    bench("cr_exp_slow_path", cr_exp, exp_slow);
+    bench("my_exp_slow_path", my_exp, exp_slow);
+    return 0;
+}
@@ -0,0 +1,105 @@
+#ifndef CORRECTLY_ROUNDED_H
+#define CORRECTLY_ROUNDED_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <quadmath.h>
+
+#include "log_accurate.h"
+#include "logaddexp.h"
+#include "util.h"
+
+// Correctly rounded float log and exp, with Ziv's strategy: evaluate the
+// function in double with a known error bound, and if the float rounding of
+// the double result is certain, return it. Otherwise, the exact result may be
+// on the other side of the midpoint between two floats, so evaluate again in
+// __float128 and round that. The double kernels are accurate to about 2^-50,
+// and the midpoints are 2^-24 apart, so the slow path is rare.
+//
+// The error bounds of the double kernels were measured against __float128 on
+// random inputs, and have a margin of 4x. The exhaustive check in
+// correctly_rounded.cc proves that all the float results are correct.
+
+// The error of log_positive is below 2^-50 * |y| + 2^-52, where the absolute
+// part comes from the cancellation near x = 1.
+constexpr double CRLogRelErr = 0x1p-48;
+constexpr double CRLogAbsErr = 0x1p-50;
+// The error of exp_neg_reduced is below 2^-50 * y.
+constexpr double CRExpRelErr = 0x1p-48;
+
+/// @return True if every value in [y - err .. y + err] rounds to the same
+/// float as \p y.
+inline bool float_rounding_is_safe(double y, double err) {
+    // Find the float exponent of y. The denormals share the exponent -126.
+    uint64_t bits = bit_cast<uint64_t, double>(y) & 0x7fffffffffffffff;
+    int e = std::max(int(bits >> 52) - 1023, -126);
+
+    // Scale y to the float grid, where the floats are the integers and the
+    // midpoints are the halves. The scaling by a power of two is exact.
+    double scale = bit_cast<double, uint64_t>(uint64_t(1023 + 23 - e) << 52);
+    double q = bit_cast<double, uint64_t>(bits) * scale;
+    double frac = q - std::floor(q);
+    return std::abs(frac - 0.5) > err * scale;
+}
+
+/// Compute log(x) in double, and store the float result in \p res.
+/// @return False if the rounding is not certain, and the slow path is needed.
+inline bool cr_log_fast(float x, float &res) {
+    // Handle the special values:
+    if (x == 0) {
+        res = -INFINITY;
+        return true;
+    } else if (x < 0) {
+        res = bit_cast<float, unsigned>(0xffc00000); // -Nan.
+        return true;
+    } else if (is_nan(x)) {
+        res = x;
+        return true;
+    }
+
+    // The float denormals are normal doubles.
+    double y = log_positive(x);
+    res = float(y);
+    return float_rounding_is_safe(y, std::abs(y) * CRLogRelErr + CRLogAbsErr);
+}
+
+/// Compute exp(x) in double, and store the float result in \p res.
+/// @return False if the rounding is not certain, and the slow path is needed.
+inline bool cr_exp_fast(float x, float &res) {
+    if (x >= 89) {
+        res = INFINITY;
+        return true;
+    } else if (x <= -104) {
+        // exp(-104) is below half of the smallest denormal.
+        res = 0;
+        return true;
+    } else if (is_nan(x)) {
+        res = x;
+        return true;
+    }
+
+    double y = exp_neg_reduced(-double(x));
+    res = float(y);
+    return float_rounding_is_safe(y, y * CRExpRelErr);
+}
+
+/// @return the correctly rounded log(x).
+KERNEL_API float cr_log(float x) {
+    float res;
+    if (cr_log_fast(x, res)) {
+        return res;
+    }
+    return float(logq(__float128(x)));
+}
+
+/// @return the correctly rounded exp(x).
+KERNEL_API float cr_exp(float x) {
+    float res;
+    if (cr_exp_fast(x, res)) {
+        return res;
+    }
+    return float(expq(__float128(x)));
+}
+
+#endif // CORRECTLY_ROUNDED_H
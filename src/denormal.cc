@@ -0,0 +1,94 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "activation.h"
+#include "denormal.h"
+#include "log_float.h"
+#include "util.h"
+
+// The default kernels with FTZ and DAZ enabled for the call. The mode is per
+// thread, so the verifier threads set it for every call.
+float my_log_flushed(float x) {
+    ScopedFlushDenormals guard;
+    return my_log(x);
+}
+float my_exp_flushed(float x) {
+    ScopedFlushDenormals guard;
+    return my_exp(x);
+}
+
+void check() {
+    assert(!denormals_are_flushed());
+    {
+        ScopedFlushDenormals guard;
+        assert(denormals_are_flushed());
+        // DAZ: the denormal input is zero. FTZ: the denormal result is zero.
+        volatile float d = 0x1p-140f;
+        assert(d == 0);
+        volatile float n = 0x1p-100f;
+        assert(n * n == 0);
+        {
+            ScopedFlushDenormals nested;
+            assert(denormals_are_flushed());
+        }
+        assert(denormals_are_flushed());
+    }
+    assert(!denormals_are_flushed());
+
+    assert(my_log_daz(0x1p-140f) == -INFINITY && my_log_daz(-0x1p-140f) == -INFINITY);
+    assert(my_log_daz(0x1p-126f) == my_log(0x1p-126f));
+    assert(std::isnan(my_log_daz(-1)) && std::isnan(my_log_daz(NAN)));
+    assert(my_exp_ftz(-90) == 0 && my_exp(-90) != 0);
+    assert(my_exp_ftz(-87) == my_exp(-87) && my_exp_ftz(100) == INFINITY);
+}
+
+/// Benchmark \p handle on the inputs \p iv, with the default MXCSR mode, and
+/// with FTZ and DAZ.
+void bench_modes(const std::string &name, float (*handle)(float), const std::vector<float> &iv) {
+    bench_throughput(name + "         ", handle, iv, 1000);
+    ScopedFlushDenormals guard;
+    bench_throughput(name + "_flushed ", handle, iv, 1000);
+}
+
+/// @return \p count random floats whose bit patterns are in [first .. last].
+std::vector<float> generate_bit_patterns(uint32_t first, uint32_t last, unsigned count) {
+    std::mt19937 mt(42);
+    std::uniform_int_distribution<uint32_t> dist(first, last);
+    std::vector<float> res;
+    for (unsigned i = 0; i < count; i++) {
+        res.push_back(bit_cast<float, uint32_t>(dist(mt)));
+    }
+    return res;
+}
+
+int main(int argc, char **argv) {
+    check();
+
+    // The software variants match the default kernels under FTZ and DAZ on
+    // all the floats.
+    print_ulp_deltas(my_log_daz, my_log_flushed);
+    print_ulp_deltas(my_exp_ftz, my_exp_flushed);
+
+    // Denormal inputs for log, inputs with denormal results for exp and
+    // sigmoid, and the same kernels on normal inputs.
+    std::vector<float> normal_iv = generate_test_vector<float>(0.01, 1000., 10000);
+    std::vector<float> denormal_iv = generate_bit_patterns(0x00000001, 0x007fffff, 10000);
+    std::vector<float> exp_normal_iv = generate_test_vector<float>(-80., -70., 10000);
+    std::vector<float> exp_denormal_iv = generate_test_vector<float>(-103., -88., 10000);
+
+    bench_modes("my_log_normal_inputs        ", my_log, normal_iv);
+    bench_modes("my_log_denormal_inputs      ", my_log, denormal_iv);
+    bench_modes("my_log_daz_denormal_inputs  ", my_log_daz, denormal_iv);
+    bench_modes("my_log_float_denormal_inputs", my_log_float, denormal_iv);
+    bench_modes("my_exp_normal_results       ", my_exp, exp_normal_iv);
+    bench_modes("my_exp_denormal_results     ", my_exp, exp_denormal_iv);
+    bench_modes("my_exp_ftz_denormal_results ", my_exp_ftz, exp_denormal_iv);
+    bench_modes("my_sigmoid_normal_results   ", my_sigmoid, exp_normal_iv);
+    bench_modes("my_sigmoid_denormal_results ", my_sigmoid, exp_denormal_iv);
+    return 0;
+}
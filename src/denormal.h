@@ -0,0 +1,70 @@
+#ifndef DENORMAL_H
+#define DENORMAL_H
+
+#include <cmath>
+#include <cstdint>
+#include <xmmintrin.h>
+
+#include "domain.h"
+#include "exp_accurate.h"
+#include "log_accurate.h"
+#include "util.h"
+
+// Kernel variants for the pipelines that run with flush-to-zero (FTZ) and
+// denormals-are-zero (DAZ), or that want the same results without paying for
+// the microcode assists of the denormals: my_log rescales the denormal inputs
+// and recurses in reduce_fp32, and my_exp returns denormals below -87.
+//
+// The variants flush in software: the denormal inputs of log are zero, and
+// the denormal results of exp are zero. Their results are the results of the
+// default kernels under ScopedFlushDenormals, for all the inputs.
+
+/// The FTZ and DAZ bits of the MXCSR register.
+constexpr unsigned MXCSRFlushToZero = 0x8000;
+constexpr unsigned MXCSRDenormalsAreZero = 0x0040;
+
+/// Enables FTZ and DAZ for the current thread, and restores the previous mode
+/// at the end of the scope. The mode is per thread, so each worker thread of
+/// a pipeline needs its own guard.
+class ScopedFlushDenormals {
+    unsigned saved_;
+
+  public:
+    ScopedFlushDenormals() : saved_(_mm_getcsr()) {
+        _mm_setcsr(saved_ | MXCSRFlushToZero | MXCSRDenormalsAreZero);
+    }
+    ~ScopedFlushDenormals() { _mm_setcsr(saved_); }
+    ScopedFlushDenormals(const ScopedFlushDenormals &) = delete;
+    ScopedFlushDenormals &operator=(const ScopedFlushDenormals &) = delete;
+};
+
+/// @return True if FTZ and DAZ are enabled for the current thread.
+inline bool denormals_are_flushed() {
+    unsigned mask = MXCSRFlushToZero | MXCSRDenormalsAreZero;
+    return (_mm_getcsr() & mask) == mask;
+}
+
+/// Compute log(x), where the denormal inputs are zero, like DAZ.
+inline float log_daz_impl(float x) {
+    // The comparison is also true for zero, and for the negative denormals,
+    // which are -0.
+    if (std::abs(x) < 0x1p-126f) {
+        return bit_cast<float, unsigned>(0xff800000); // -Inf
+    }
+    return my_log_in<NoDenormals>(x);
+}
+
+/// Compute exp(x), where the denormal results are zero, like FTZ.
+inline float exp_ftz_impl(float x) {
+    // The largest float where my_exp(x) is below the smallest normal float,
+    // which is close to log(2^-126).
+    if (x <= -0x1.5d58ap+6f) {
+        return 0;
+    }
+    return my_exp_in<AnyInput>(x);
+}
+
+KERNEL_API float my_log_daz(float x) { return log_daz_impl(x); }
+KERNEL_API float my_exp_ftz(float x) { return exp_ftz_impl(x); }
+
+#endif // DENORMAL_H
@@ -0,0 +1,73 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "domain.h"
+#include "exp_accurate.h"
+#include "log_accurate.h"
+#include "util.h"
+
+// The kernels with a contract, as functions for the verifier.
+float log_positive_normal(float x) { return my_log_in<PositiveNormal>(x); }
+float log_positive(float x) { return my_log_in<Positive>(x); }
+float exp_safe_range(float x) { return my_exp_in<SafeExpRange>(x); }
+float exp_finite(float x) { return my_exp_in<Finite>(x); }
+
+void check() {
+    assert(PositiveNormal::contains(1) && !PositiveNormal::contains(0x1p-127f));
+    assert(!PositiveNormal::contains(0) && !PositiveNormal::contains(INFINITY));
+    assert(Positive::contains(0x1p-149f) && !Positive::contains(-1));
+    assert(Finite::contains(-1) && !Finite::contains(NAN));
+    assert(SafeExpRange::contains(-87) && SafeExpRange::contains(88));
+    assert(!SafeExpRange::contains(89) && !SafeExpRange::contains(NAN));
+
+    // The contract types are ordered.
+    static_assert(!PositiveNormal::MayBeDenormal && Positive::MayBeDenormal);
+    static_assert(!SafeExpRange::MayOverflowExp && Finite::MayOverflowExp);
+    static_assert(!Positive::MayBeNaN && !Positive::MayBeNonPositive);
+}
+
+/// Benchmark a loop that calls \p Kernel, where the kernel can be inlined.
+template <float (*Kernel)(float)>
+void bench_loop(const std::string &name, const std::vector<float> &iv) {
+    std::vector<float> out(iv.size());
+    auto t1 = high_resolution_clock::now();
+    float sum = 0;
+    for (int iter = 0; iter < 10000; iter++) {
+        for (size_t i = 0; i < iv.size(); i++) {
+            out[i] = Kernel(iv[i]);
+        }
+        sum += out[iter % out.size()];
+    }
+    auto t2 = high_resolution_clock::now();
+    std::cout << "name = " << name << ", sum = " << sum << ", time = "
+              << duration_cast<milliseconds>(t2 - t1).count() << "ms\n";
+}
+
+int main(int argc, char **argv) {
+    check();
+
+    // The kernels with a contract match the full kernels on the whole domain.
+    print_ulp_deltas(log_positive_normal, my_log, 0x00800000, 0x7f800000);
+    print_ulp_deltas(log_positive, my_log, 0x00000001, 0x7f800000);
+    // [0 .. 88], and [-0 .. -87].
+    print_ulp_deltas(exp_safe_range, my_exp, 0x00000000, 0x42b00001);
+    print_ulp_deltas(exp_safe_range, my_exp, 0x80000000, 0xc2ae0001);
+    print_ulp_deltas(exp_finite, my_exp, 0x00000000, 0x7f800000);
+
+    std::vector<float> iv = generate_test_vector<float>(0.01, 1000., 10000);
+    std::vector<float> ev = generate_test_vector<float>(-80., 80., 10000);
+    bench_loop<my_log>("my_log                     ", iv);
+    bench_loop<my_log_in<AnyInput>>("my_log_in<AnyInput>        ", iv);
+    bench_loop<my_log_in<Positive>>("my_log_in<Positive>        ", iv);
+    bench_loop<my_log_in<PositiveNormal>>("my_log_in<PositiveNormal>  ", iv);
+    bench_loop<my_exp>("my_exp                     ", ev);
+    bench_loop<my_exp_in<AnyInput>>("my_exp_in<AnyInput>        ", ev);
+    bench_loop<my_exp_in<Finite>>("my_exp_in<Finite>          ", ev);
+    bench_loop<my_exp_in<SafeExpRange>>("my_exp_in<SafeExpRange>    ", ev);
+    return 0;
+}
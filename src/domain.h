@@ -0,0 +1,73 @@
+#ifndef DOMAIN_H
+#define DOMAIN_H
+
+#include <cassert>
+#include <cmath>
+
+// Input domain contracts for the scalar kernels. The call sites that know more
+// about their inputs than the kernel does, e.g. probabilities after clamping
+// or the logits of a softmax, pass a contract as a template argument, and the
+// kernel compiles away the checks for the values outside of the domain. The
+// result for an input outside of the contract is undefined.
+//
+// Define CHECK_CONTRACTS to assert the contracts, e.g. in debug builds. The
+// check is off by default, because the benchmarks here are built with asserts.
+
+/// Any float, including zero, the negative values, the denormals, the
+/// infinities and NaN.
+struct AnyInput {
+    static constexpr bool MayBeNaN = true;
+    static constexpr bool MayBeInf = true;
+    static constexpr bool MayBeNonPositive = true;
+    static constexpr bool MayBeDenormal = true;
+    static constexpr bool MayOverflowExp = true;
+    static bool contains(float x) { return true; }
+};
+
+/// Not an infinity and not NaN.
+struct Finite : AnyInput {
+    static constexpr bool MayBeNaN = false;
+    static constexpr bool MayBeInf = false;
+    static bool contains(float x) { return std::isfinite(x); }
+};
+
+/// A positive and finite float, which may be denormal.
+struct Positive : Finite {
+    static constexpr bool MayBeNonPositive = false;
+    static bool contains(float x) { return x > 0 && std::isfinite(x); }
+};
+
+/// A positive and finite float that is not a denormal.
+struct PositiveNormal : Positive {
+    static constexpr bool MayBeDenormal = false;
+    static bool contains(float x) { return x >= 0x1p-126f && x <= 0x1.fffffep127f; }
+};
+
+/// Any float except the denormals, e.g. after the denormals are flushed to
+/// zero (see denormal.h).
+struct NoDenormals : AnyInput {
+    static constexpr bool MayBeDenormal = false;
+    static bool contains(float x) { return !(std::abs(x) < 0x1p-126f) || x == 0; }
+};
+
+/// The range [-87 .. 88], where exp(x) is a normal float.
+struct SafeExpRange : Finite {
+    static constexpr bool MayOverflowExp = false;
+    static bool contains(float x) { return x >= -87 && x <= 88; }
+};
+
+/// The range (-710 .. 710) of the exp table, where exp(x) may round to a
+/// denormal, to zero or to infinity, but the reduction doesn't overflow.
+struct ExpTableRange : Finite {
+    static constexpr bool MayOverflowExp = false;
+    static bool contains(float x) { return x > -710 && x < 710; }
+};
+
+/// Assert that \p x is in \p Domain, when CHECK_CONTRACTS is defined.
+template <class Domain> inline void check_contract(float x) {
+#ifdef CHECK_CONTRACTS
+    assert(Domain::contains(x) && "The input is outside of the domain contract");
+#endif
+}
+
+#endif // DOMAIN_H
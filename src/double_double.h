@@ -0,0 +1,90 @@
+#ifndef DOUBLE_DOUBLE_H
+#define DOUBLE_DOUBLE_H
+
+#include <cmath>
+
+// Double-double arithmetic: a value is the unevaluated sum hi + lo of two
+// doubles, where |lo| is below half an ULP of hi, which gives about 106 bits
+// of precision. See the Handbook of Floating-Point Arithmetic -- Jean-Michel
+// Muller, Chapter 14. The algorithms rely on the IEEE rounding of each
+// operation, so they must not be compiled with -ffast-math.
+
+struct DoubleDouble {
+    double hi;
+    double lo;
+};
+
+/// @return the exact sum of \p a and \p b, for any two doubles (TwoSum).
+inline DoubleDouble two_sum(double a, double b) {
+    double s = a + b;
+    double bb = s - a;
+    double err = (a - (s - bb)) + (b - bb);
+    return { s, err };
+}
+
+/// @return the exact sum of \p a and \p b, where |a| >= |b| or a is zero
+/// (Fast2Sum).
+inline DoubleDouble fast_two_sum(double a, double b) {
+    double s = a + b;
+    double err = b - (s - a);
+    return { s, err };
+}
+
+/// @return the exact product of \p a and \p b.
+inline DoubleDouble two_prod(double a, double b) {
+    double p = a * b;
+    double err = std::fma(a, b, -p);
+    return { p, err };
+}
+
+/// @return a + b, with a relative error below 2^-103.
+inline DoubleDouble dd_add(DoubleDouble a, DoubleDouble b) {
+    DoubleDouble s = two_sum(a.hi, b.hi);
+    DoubleDouble t = two_sum(a.lo, b.lo);
+    s.lo += t.hi;
+    s = fast_two_sum(s.hi, s.lo);
+    s.lo += t.lo;
+    return fast_two_sum(s.hi, s.lo);
+}
+
+/// @return a + b, with an error below 2^-105 * (|a| + |b|). This is cheaper
+/// than dd_add, but the relative error grows when a and b cancel.
+inline DoubleDouble dd_add_sloppy(DoubleDouble a, DoubleDouble b) {
+    DoubleDouble s = two_sum(a.hi, b.hi);
+    s.lo += a.lo + b.lo;
+    return fast_two_sum(s.hi, s.lo);
+}
+
+/// @return a + b, with a relative error below 2^-104.
+inline DoubleDouble dd_add(DoubleDouble a, double b) {
+    DoubleDouble s = two_sum(a.hi, b);
+    s.lo += a.lo;
+    return fast_two_sum(s.hi, s.lo);
+}
+
+/// @return a * b, with a relative error below 2^-102.
+inline DoubleDouble dd_mul(DoubleDouble a, DoubleDouble b) {
+    DoubleDouble p = two_prod(a.hi, b.hi);
+    p.lo += a.hi * b.lo + a.lo * b.hi;
+    return fast_two_sum(p.hi, p.lo);
+}
+
+/// @return a * b, with a relative error below 2^-103.
+inline DoubleDouble dd_mul(DoubleDouble a, double b) {
+    DoubleDouble p = two_prod(a.hi, b);
+    p.lo += a.lo * b;
+    return fast_two_sum(p.hi, p.lo);
+}
+
+/// @return a * b + c, for a Horner step where |a * b| is below |c| / 2. The
+/// result is not normalized, and |lo| may be slightly above half an ULP of
+/// hi, which is harmless for the next step.
+inline DoubleDouble dd_mul_add(DoubleDouble a, double b, DoubleDouble c) {
+    DoubleDouble p = two_prod(a.hi, b);
+    p.lo = std::fma(a.lo, b, p.lo);
+    DoubleDouble s = fast_two_sum(c.hi, p.hi);
+    s.lo += p.lo + c.lo;
+    return s;
+}
+
+#endif // DOUBLE_DOUBLE_H
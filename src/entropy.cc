@@ -0,0 +1,116 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "entropy.h"
+#include "util.h"
+
+// The term p * log(p) of the entropy sum.
+float xlogx(float x) { return x * log_positive(x); }
+
+// Use the standard log(double) as the ground truth. x * log(x) approaches
+// zero from below, and the kernel computes 0 * log_positive(0) = -0.
+float accurate_xlogx(float x) { return x == 0 ? -0.f : x * log((double)x); }
+
+// The straightforward implementation, with a separate libm log per bucket.
+double libm_sum_p_log_p(const float *p, size_t n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += p[i] == 0 ? 0 : p[i] * logf(p[i]);
+    }
+    return sum;
+}
+
+// Compute the sums in long double as the ground truth.
+long double accurate_sum_p_log_p(const float *p, size_t n) {
+    long double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += p[i] == 0 ? 0 : p[i] * logl(p[i]);
+    }
+    return sum;
+}
+
+long double accurate_sum_p_log_p_over_q(const float *p, const float *q, size_t n) {
+    long double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += p[i] == 0 ? 0 : p[i] * logl((long double)p[i] / q[i]);
+    }
+    return sum;
+}
+
+/// @return a histogram with \p n buckets that sums to one. The bucket weights
+/// are uniform in [lo .. 1], and negative weights become empty buckets.
+std::vector<float> generate_histogram(unsigned n, float lo) {
+    std::vector<float> h = generate_test_vector<float>(lo, 1., n);
+    double total = 0;
+    for (auto &elem : h) {
+        elem = std::max<float>(0, elem);
+        total += elem;
+    }
+    for (auto &elem : h) {
+        elem /= total;
+    }
+    return h;
+}
+
+void check() {
+    // The entropy of the uniform distribution is log(n).
+    std::vector<float> uniform(1000, 1. / 1024);
+    double h = -sum_p_log_p(uniform.data(), uniform.size());
+    assert(std::abs(h - 1000 * log(1024.) / 1024) < 1e-12);
+    // The divergence of a distribution from itself is zero.
+    std::vector<float> p = generate_histogram(1001, -0.2);
+    assert(sum_p_log_p_over_q(p.data(), p.data(), p.size()) == 0);
+    // Empty buckets in q that are not empty in p give infinite divergence.
+    std::vector<float> q = p;
+    q[500] = 0;
+    p[500] = 1e-30;
+    assert(std::isinf(sum_p_log_p_over_q(p.data(), q.data(), q.size())));
+    p[500] = 0;
+    assert(std::isfinite(sum_p_log_p_over_q(p.data(), q.data(), q.size())));
+}
+
+int main(int argc, char **argv) {
+    check();
+    // Check the accuracy of a single term over all non-negative floats.
+    print_ulp_deltas(xlogx, accurate_xlogx, 0, 0x7f800000);
+
+    std::vector<float> p = generate_histogram(1 << 20, -0.2);
+    std::vector<float> q = generate_histogram(1 << 20, 0.1);
+    double h = sum_p_log_p(p.data(), p.size());
+    double kl = sum_p_log_p_over_q(p.data(), q.data(), p.size());
+    long double ref_h = accurate_sum_p_log_p(p.data(), p.size());
+    long double ref_kl = accurate_sum_p_log_p_over_q(p.data(), q.data(), p.size());
+    printf("sum(p*log(p))   = %.17g, relative error %.3g\n", h, double((h - ref_h) / ref_h));
+    printf("sum(p*log(p/q)) = %.17g, relative error %.3g\n", kl, double((kl - ref_kl) / ref_kl));
+
+    // The kernels are pure, so shift the inputs in each iteration to prevent
+    // the compiler from hoisting the calls out of the loop.
+    const int iterations = 100;
+    auto t1 = high_resolution_clock::now();
+    double sum = 0;
+    for (int iter = 0; iter < iterations; iter++) {
+        sum += sum_p_log_p(p.data() + (iter & 1), p.size() - 1);
+    }
+    auto t2 = high_resolution_clock::now();
+    for (int iter = 0; iter < iterations; iter++) {
+        sum += libm_sum_p_log_p(p.data() + (iter & 1), p.size() - 1);
+    }
+    auto t3 = high_resolution_clock::now();
+    for (int iter = 0; iter < iterations; iter++) {
+        sum += sum_p_log_p_over_q(p.data() + (iter & 1), q.data(), p.size() - 1);
+    }
+    auto t4 = high_resolution_clock::now();
+    std::cout << "sum = " << sum << "\n";
+    std::cout << "name = sum_p_log_p, time = " << duration_cast<milliseconds>(t2 - t1).count()
+              << "ms\n";
+    std::cout << "name = libm_sum_p_log_p, time = "
+              << duration_cast<milliseconds>(t3 - t2).count() << "ms\n";
+    std::cout << "name = sum_p_log_p_over_q, time = "
+              << duration_cast<milliseconds>(t4 - t3).count() << "ms\n";
+    return 0;
+}
@@ -0,0 +1,92 @@
+#ifndef ENTROPY_H
+#define ENTROPY_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "log_accurate.h"
+#include "util.h"
+
+/// A compensated (Kahan) accumulator in double precision.
+struct KahanSum {
+    double sum_ = 0;
+    // The rounding error of the last addition, which is subtracted from the
+    // next value.
+    double err_ = 0;
+
+    void add(double x) {
+        double y = x - err_;
+        double t = sum_ + y;
+        err_ = (t - sum_) - y;
+        sum_ = t;
+    }
+    // Add the partial sum of another accumulator.
+    void join(const KahanSum &other) {
+        add(other.sum_);
+        add(-other.err_);
+    }
+    double get() const { return sum_ - err_; }
+};
+
+/// The number of independent accumulators. This breaks the dependency chain
+/// of the summation, and allows the compiler to vectorize the lanes.
+constexpr unsigned EntropyLanes = 8;
+
+/// @return the sum of p[i] * log(p[i]) for the \p n non-negative and finite
+/// values in \p p. Buckets with p = 0 contribute zero. The Shannon entropy is
+/// the negated result.
+KERNEL_API double sum_p_log_p(const float *p, size_t n) {
+    KahanSum acc[EntropyLanes];
+    size_t i = 0;
+    for (; i + EntropyLanes <= n; i += EntropyLanes) {
+        for (unsigned l = 0; l < EntropyLanes; l++) {
+            // The conversion to double normalizes the float denormals, and
+            // log_positive(0) is finite, so zero needs no branch.
+            double x = p[i + l];
+            acc[l].add(x * log_positive(x));
+        }
+    }
+    for (; i < n; i++) {
+        double x = p[i];
+        acc[0].add(x * log_positive(x));
+    }
+
+    for (unsigned l = 1; l < EntropyLanes; l++) {
+        acc[0].join(acc[l]);
+    }
+    return acc[0].get();
+}
+
+/// @return the sum of p[i] * log(p[i] / q[i]) for the \p n non-negative and
+/// finite values in \p p and \p q. This is the KL divergence D(p || q).
+/// Buckets with p = 0 contribute zero, and the result is +Inf if some bucket
+/// has p > 0 and q = 0.
+KERNEL_API double sum_p_log_p_over_q(const float *p, const float *q, size_t n) {
+    KahanSum acc[EntropyLanes];
+    // Record the buckets with q = 0 and p > 0 without a branch.
+    unsigned inf[EntropyLanes] = { 0 };
+    size_t i = 0;
+    for (; i + EntropyLanes <= n; i += EntropyLanes) {
+        for (unsigned l = 0; l < EntropyLanes; l++) {
+            double x = p[i + l];
+            double y = q[i + l];
+            inf[l] |= (x > 0) & (y == 0);
+            acc[l].add(x * (log_positive(x) - log_positive(y)));
+        }
+    }
+    for (; i < n; i++) {
+        double x = p[i];
+        double y = q[i];
+        inf[0] |= (x > 0) & (y == 0);
+        acc[0].add(x * (log_positive(x) - log_positive(y)));
+    }
+
+    for (unsigned l = 1; l < EntropyLanes; l++) {
+        acc[0].join(acc[l]);
+        inf[0] |= inf[l];
+    }
+    return inf[0] ? INFINITY : acc[0].get();
+}
+
+#endif // ENTROPY_H
@@ -0,0 +1,90 @@
+#ifndef EXP_ACCURATE_H
+#define EXP_ACCURATE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "domain.h"
+#include "exp_table.h"
+#include "poly.h"
+#include "util.h"
+
+// The minimax polynomial of exp(x) in the range [-0.0039 .. 0.0039].
+// Generated with Sollya:
+//   Q = fpminimax(exp(x), 5, [|D...|], [-0.0039, 0.0039])
+inline constexpr double exp_pol_coeffs[6] = {
+    1., 1., 0.49999999999985944576508245518198236823081970214844,
+    0.166666666666697105281258473041816614568233489990234,
+    4.1666696240209417922972789938285131938755512237549e-2,
+    8.3333337622652735310335714302709675393998622894287e-3,
+};
+
+// Approximate the function \p exp in the range -0.004, 0.004.
+template <PolyScheme Scheme = PolyScheme::Horner> double approximate_exp_pol_around_zero(double x) {
+    return poly<Scheme>(x, exp_pol_coeffs);
+}
+
+/// Compute exp(x) for \p x in the domain contract \p Domain (see domain.h).
+/// The checks for the values outside of the domain are compiled away.
+template <class Domain> inline float my_exp_in(float x) {
+    check_contract<Domain>(x);
+
+    if constexpr (Domain::MayOverflowExp) {
+        if (x >= 710) {
+            return bit_cast<float, unsigned>(0x7f800000); // Inf
+        } else if (x <= -710) {
+            return 0;
+        }
+    }
+    if constexpr (Domain::MayBeNaN) {
+        if (is_nan(x)) {
+            return x;
+        }
+    }
+
+    // Split X into 3 numbers such that: x = I1 + (I2 << 8) + xt;
+    int Int1 = int(x);
+    x = x - Int1;
+    int Int2 = int(x * 256);
+    x = x - (float(Int2) / 256);
+
+    // The scalar kernel is limited by latency, so use Estrin's scheme. The
+    // indices are widened to size_t, which lets GCC emit the lookups as
+    // gathers.
+    size_t idx1 = Int1 + 710;
+    size_t idx2 = Int2 + 256;
+    return approximate_exp_pol_around_zero<PolyScheme::Estrin>(x) * EXP_TABLE[idx1] *
+           EXP_TABLE_r256[idx2];
+}
+
+KERNEL_API float my_exp(float x) { return my_exp_in<AnyInput>(x); }
+
+/// Compute \p out[i] = exp(\p in[i]) for \p n elements. The kernel may run
+/// in place, with \p in == \p out, but the arrays must not overlap otherwise.
+KERNEL_API void my_exp(const float *in, float *out, size_t n) {
+    // The kernel runs on blocks of a copy of the inputs, which the results
+    // don't overwrite. The first loop vectorizes, and the second one fixes the
+    // inputs outside of [-87 .. 88], where the result is not a normal float.
+    // The first loop clamps the inputs, which keeps the table indices in
+    // bounds.
+    constexpr size_t BlockSize = 256;
+    float block[BlockSize];
+    for (size_t first = 0; first < n; first += BlockSize) {
+        size_t len = std::min(BlockSize, n - first);
+        std::copy(in + first, in + first + len, block);
+        for (size_t i = 0; i < len; i++) {
+            float x = blend(-uint32_t(block[i] > -87.f), block[i], -87.f);
+            out[first + i] = my_exp_in<SafeExpRange>(blend(-uint32_t(x < 88.f), x, 88.f));
+        }
+        for (size_t i = 0; i < len; i++) {
+            if (!SafeExpRange::contains(block[i])) {
+                out[first + i] = my_exp_in<AnyInput>(block[i]);
+            }
+        }
+    }
+}
+
+#endif // EXP_ACCURATE_H
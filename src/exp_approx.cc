@@ -4,29 +4,25 @@
 #include <numbers>
 #include <vector>
 
-#include "exp_table.h"
+#include "exp_approx.h"
+#include "poly.h"
 #include "util.h"
 
 double __attribute__((noinline)) nop(double x) { return x + 1; }
 
-double __attribute__((noinline)) fast_exp(double x) {
-    double integer = trunc(x);
-    // X is now the fractional part of the number.
-    x = x - integer;
-
-    // Use a 4-part polynomial to approximate exp(x);
-    double c[] = { 0.28033708, 0.425302, 1.01273643, 1.00020947 };
-
-    // Use Horner's method to evaluate the polynomial.
-    double val = c[3] + x * (c[2] + x * (c[1] + x * (c[0])));
-    return val * EXP_TABLE[(unsigned)integer + 710];
-}
-
 int main(int argc, char **argv) {
     std::vector<double> iv = generate_test_vector(-10., 10., 10000);
     bench("nop", nop, iv);
     bench("trunc", trunc, iv);
-    bench("fast_exp", fast_exp, iv);
+    bench("fast_exp", fast_exp<>, iv);
     bench("libm_exp", exp, iv);
+
+    // The latency and the throughput of the polynomial schemes.
+    bench_latency("fast_exp_horner_latency    ", fast_exp<PolyScheme::Horner>, iv);
+    bench_latency("fast_exp_estrin_latency    ", fast_exp<PolyScheme::Estrin>, iv);
+    bench_latency("fast_exp_even_odd_latency  ", fast_exp<PolyScheme::EvenOdd>, iv);
+    bench_throughput("fast_exp_horner_throughput  ", fast_exp<PolyScheme::Horner>, iv);
+    bench_throughput("fast_exp_estrin_throughput  ", fast_exp<PolyScheme::Estrin>, iv);
+    bench_throughput("fast_exp_even_odd_throughput", fast_exp<PolyScheme::EvenOdd>, iv);
     return 0;
 }
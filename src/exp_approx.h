@@ -0,0 +1,30 @@
+#ifndef EXP_APPROX_H
+#define EXP_APPROX_H
+
+#include <cmath>
+
+#include "exp_table.h"
+#include "poly.h"
+#include "util.h"
+
+// The minimax polynomial of exp(x) in the range [-1 .. 1], the range of the
+// fraction x - trunc(x), with a relative error of 2^-7.6. Generated with:
+//   remez --name fast_exp_coeffs exp -1 1 3
+inline constexpr double fast_exp_coeffs[4] = {
+    0x1.fe368259ab2ap-1, 0x1.02c4068656f03p+0, 0x1.13e418f4c8b7fp-1, 0x1.44a491c50d5ddp-3,
+};
+
+/// Approximate exp(x) with a degree-3 polynomial of the fraction of \p x, and
+/// the table of the integer powers. This is the fast and inaccurate sibling of
+/// my_exp, for |x| < 710.
+template <PolyScheme Scheme = PolyScheme::Horner> KERNEL_API double fast_exp(double x) {
+    double integer = trunc(x);
+    // X is now the fractional part of the number.
+    x = x - integer;
+
+    // Use a 4-part polynomial to approximate exp(x);
+    double val = poly<Scheme>(x, fast_exp_coeffs);
+    return val * EXP_TABLE[int(integer) + 710];
+}
+
+#endif // EXP_APPROX_H
@@ -4,7 +4,7 @@
 // Generated with:
 // >>> from math import exp
 // >>> [exp(i) for i in range(-710, 710)]
-double EXP_TABLE[1420] = {
+inline constexpr double EXP_TABLE[1420] = {
     4.47628622567513e-309,   1.216780750623423e-308,  3.307553003638408e-308,
     8.99086122645542e-308,   2.443969469407077e-307,  6.643397797997952e-307,
     1.8058627513522668e-306, 4.9088439016919216e-306, 1.334362117671115e-305,
@@ -482,7 +482,7 @@ double EXP_TABLE[1420] = {
 };
 
 // [exp(i/256.) for i in range(-256, 256)]
-double EXP_TABLE_r256[512] = { 0.36787944117144233,
+inline constexpr double EXP_TABLE_r256[512] = { 0.36787944117144233,
                                0.3693192805940405,
                                0.3707647553888037,
                                0.372215887611955,
@@ -0,0 +1,33 @@
+#ifndef FAST_LOG_H
+#define FAST_LOG_H
+
+// The header-only library of the kernels. Every function is inline and every
+// table is inline constexpr, so the header can be included from any number of
+// translation units of a program, and the call sites inline the kernels.
+//
+// Two headers are not part of the library: correctly_rounded.h and
+// reference.h need libquadmath, and vector_abi.h defines the symbols of the
+// vector function ABI, which belong to exactly one translation unit.
+
+#include "activation.h"
+#include "denormal.h"
+#include "domain.h"
+#include "double_double.h"
+#include "entropy.h"
+#include "erf.h"
+#include "exp_accurate.h"
+#include "exp_approx.h"
+#include "gamma.h"
+#include "half.h"
+#include "log_accurate.h"
+#include "log_approx.h"
+#include "log_dd.h"
+#include "log_float.h"
+#include "log_int.h"
+#include "logaddexp.h"
+#include "piecewise.h"
+#include "poly.h"
+#include "quant.h"
+#include "sum_log.h"
+
+#endif // FAST_LOG_H
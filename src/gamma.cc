@@ -0,0 +1,240 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "gamma.h"
+#include "reference.h"
+#include "util.h"
+
+/// @return the Hurwitz zeta function zeta(s, a) in __float128, for an integer
+/// s >= 2 and a > 0: the first 40 terms of the sum, and the Euler-Maclaurin
+/// formula for the rest.
+__float128 hurwitz_zeta_quad(int s, __float128 a) {
+    // B_2j / (2j)!.
+    static const __float128 coeffs[12] = {
+        1.Q / 12,
+        -1.Q / 720,
+        1.Q / 30240,
+        -1.Q / 1209600,
+        1.Q / 47900160,
+        -691.Q / 1307674368000,
+        1.Q / 74724249600,
+        -3617.Q / 10670622842880000,
+        43867.Q / 5109094217170944000,
+        -174611.Q / 802857662698291200000.Q,
+        77683.Q / 14101100039391805440000.Q,
+        -236364091.Q / 1693824136731743669452800000.Q,
+    };
+    constexpr int N = 40;
+    __float128 sum = 0;
+    for (int n = 0; n < N; n++) {
+        sum += powq(a + n, -s);
+    }
+    __float128 w = a + N;
+    sum += powq(w, 1 - s) / (s - 1) + powq(w, -s) / 2;
+    // The rising factorial s * (s + 1) * ... * (s + 2j - 2).
+    __float128 rising = s;
+    for (int j = 1; j <= 12; j++) {
+        if (j > 1) {
+            rising *= __float128(s + 2 * j - 3) * (s + 2 * j - 2);
+        }
+        sum += coeffs[j - 1] * rising * powq(w, -s - 2 * j + 1);
+    }
+    return sum;
+}
+
+void print_coefficients(const char *name, const std::vector<__float128> &c) {
+    printf("inline constexpr double %s[%zu] = {", name, c.size());
+    for (size_t i = 0; i < c.size(); i++) {
+        if (i % 4 == 0) {
+            printf("\n   ");
+        }
+        printf(" %a,", double(c[i]));
+    }
+    printf("\n};\n");
+}
+
+/// Print the coefficients of the Taylor series of gamma.h.
+void print_gamma_tables() {
+    __float128 euler_gamma = -digamma_quad(1);
+    std::vector<__float128> a = { 1 - euler_gamma };
+    for (int k = 2; k <= 28; k++) {
+        a.push_back((k % 2 ? -1 : 1) * (hurwitz_zeta_quad(k, 1) - 1) / k);
+    }
+    print_coefficients("lgamma_2_series", a);
+
+    // Newton's method on digamma, with the derivative zeta(2, x).
+    __float128 x0 = 1.5Q;
+    for (int i = 0; i < 10; i++) {
+        x0 -= digamma_quad(x0) / hurwitz_zeta_quad(2, x0);
+    }
+    std::vector<__float128> b;
+    for (int k = 1; k <= 40; k++) {
+        b.push_back((k % 2 ? 1 : -1) * hurwitz_zeta_quad(k + 1, x0));
+    }
+    print_coefficients("digamma_root_series", b);
+
+    double hi = double(x0);
+    printf("DigammaRootHi = %a, DigammaRootLo = %a\n", hi, double(x0 - hi));
+    printf("HalfLog2Pi = %a, LogPi = %a\n", double(logq(2 * M_PIq) / 2), double(logq(M_PIq)));
+    // The low parts of the first two coefficients.
+    printf("lgamma_2_series_lo = { %a, %a }\n", double(a[0] - double(a[0])),
+           double(a[1] - double(a[1])));
+    printf("digamma_root_series_lo = { %a, %a }\n", double(b[0] - double(b[0])),
+           double(b[1] - double(b[1])));
+}
+
+void check() {
+    // The zeros, and the values at the half integers.
+    assert(my_lgamma(1.) == 0 && my_lgamma(2.) == 0);
+    assert(my_lgamma(1.f) == 0 && my_lgamma(2.f) == 0);
+    assert(std::abs(my_lgamma(0.5) - 0.5 * std::log(M_PI)) < 1e-16);
+    assert(std::abs(my_lgamma(-0.5) - std::log(2 * std::sqrt(M_PI))) < 1e-15);
+    assert(std::abs(my_lgamma(171.) - std::lgamma(171.)) < 1e-12);
+    assert(std::abs(my_digamma(1.) + 0.57721566490153286) < 1e-16);
+    assert(std::abs(my_digamma(DigammaRootHi)) < 1e-16);
+    assert(std::abs(my_digamma(0.5) + 0.57721566490153286 + 2 * std::log(2.)) < 1e-15);
+    assert(std::abs(my_digamma(-0.5) - my_digamma(1.5)) < 1e-15);
+
+    // The special values.
+    for (double x : { 0., -0., -1., -2., -1e300, double(-INFINITY), double(INFINITY) }) {
+        assert(my_lgamma(x) == INFINITY && my_lgamma(float(x)) == INFINITY);
+    }
+    assert(my_lgamma(1e306) == INFINITY && my_lgamma(1e38f) == INFINITY);
+    assert(my_digamma(0.) == -INFINITY && my_digamma(-0.) == INFINITY);
+    assert(my_digamma(0.f) == -INFINITY && my_digamma(-0.f) == INFINITY);
+    assert(my_digamma(double(INFINITY)) == INFINITY && my_digamma(float(INFINITY)) == INFINITY);
+    for (double x : { -1., -2., -1e300, double(-INFINITY), double(NAN) }) {
+        assert(std::isnan(my_digamma(x)) && std::isnan(my_digamma(float(x))));
+    }
+    assert(std::isnan(my_lgamma(double(NAN))) && std::isnan(my_lgamma(float(NAN))));
+
+    // The batch kernels match the scalar ones.
+    std::vector<float> in = generate_test_vector<float>(-20, 40, 10000);
+    for (float x : { 0.f, -0.f, -3.f, 1e-45f, 1.f, 2.f, 1e38f, float(INFINITY), float(-INFINITY),
+                     float(NAN) }) {
+        in.push_back(x);
+    }
+    std::vector<float> out(in.size());
+    my_lgamma(in.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); i++) {
+        assert(same_bits(out[i], my_lgamma(in[i])));
+    }
+    my_digamma(in.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); i++) {
+        assert(same_bits(out[i], my_digamma(in[i])));
+    }
+    // The double batch kernels, on both sides of the ranges of the series.
+    std::vector<double> din = generate_test_vector<double>(-20, 1000, 10000);
+    for (double x : { 0., -0., -3., 5e-324, 1., 9.999999999999998, 10., 11.999999999999998, 12.,
+                      0x1.fffffffffffffp51, 0x1p52, 1e300, double(INFINITY), double(-INFINITY),
+                      double(NAN) }) {
+        din.push_back(x);
+    }
+    std::vector<double> dout(din.size());
+    my_lgamma(din.data(), dout.data(), din.size());
+    for (size_t i = 0; i < din.size(); i++) {
+        assert(same_bits(dout[i], my_lgamma(din[i])));
+    }
+    my_digamma(din.data(), dout.data(), din.size());
+    for (size_t i = 0; i < din.size(); i++) {
+        assert(same_bits(dout[i], my_digamma(din[i])));
+    }
+}
+
+// The libm kernels.
+float libm_lgammaf(float x) { return lgammaf(x); }
+double libm_lgamma(double x) { return lgamma(x); }
+
+void __attribute__((noinline)) libm_lgammaf(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = lgammaf(in[i]);
+    }
+}
+void __attribute__((noinline)) libm_lgamma(const double *in, double *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = lgamma(in[i]);
+    }
+}
+
+int main(int argc, char **argv) {
+    // Print the Taylor series and the constants of gamma.h.
+    if (argc == 2 && std::string(argv[1]) == "--print-tables") {
+        print_gamma_tables();
+        return 0;
+    }
+    check();
+    // SIGINT cancels the samplings, which print their partial results.
+    cancel_verifiers_on_sigint();
+
+    // The float kernels, on random positive floats, on the patterns of
+    // [0.25 .. 16), where the series and the shifts meet, and on negative
+    // floats. The reference is __float128, so these are samples.
+    Verifier<float, unsigned, 64, 16> v1, v2, v3, v4, v5;
+    printf("\nmy_lgamma float, positive:");
+    v1.print_ulp_errors(my_lgamma, reference_lgamma<float>, 0, 0x7f800000, 1 << 22);
+    printf("\nmy_lgamma float, [0.25 .. 16):");
+    v2.print_ulp_errors(my_lgamma, reference_lgamma<float>, 0x3e800000, 0x41800000, 1 << 22);
+    printf("\nlibm lgammaf, [0.25 .. 16):");
+    v3.print_ulp_errors(libm_lgammaf, reference_lgamma<float>, 0x3e800000, 0x41800000, 1 << 22);
+    printf("\nmy_digamma float, positive:");
+    v4.print_ulp_errors(my_digamma, reference_digamma<float>, 0, 0x7f800000, 1 << 22);
+    printf("\nmy_digamma float, [0.25 .. 16):");
+    v5.print_ulp_errors(my_digamma, reference_digamma<float>, 0x3e800000, 0x41800000, 1 << 22);
+    Verifier<float, unsigned, 64, 16> v6, v7;
+    printf("\nmy_lgamma float, negative:");
+    v6.print_ulp_errors(my_lgamma, reference_lgamma<float>, 0x80000001, 0xcb000000, 1 << 20);
+    printf("\nmy_digamma float, negative:");
+    v7.print_ulp_errors(my_digamma, reference_digamma<float>, 0x80000001, 0xcb000000, 1 << 20);
+
+    // The double kernels.
+    Verifier<double, uint64_t, 64, 16> d1, d2, d3, d4, d5;
+    printf("\nmy_lgamma double, positive:");
+    d1.print_ulp_errors(my_lgamma, reference_lgamma<double>, 0, 0x7ff0000000000000, 1 << 20);
+    printf("\nmy_lgamma double, [0.25 .. 16):");
+    d2.print_ulp_errors(my_lgamma, reference_lgamma<double>, 0x3fd0000000000000,
+                        0x4030000000000000, 1 << 20);
+    printf("\nlibm lgamma, [0.25 .. 16):");
+    d3.print_ulp_errors(libm_lgamma, reference_lgamma<double>, 0x3fd0000000000000,
+                        0x4030000000000000, 1 << 20);
+    printf("\nmy_digamma double, positive:");
+    d4.print_ulp_errors(my_digamma, reference_digamma<double>, 0, 0x7ff0000000000000, 1 << 20);
+    printf("\nmy_digamma double, [0.25 .. 16):");
+    d5.print_ulp_errors(my_digamma, reference_digamma<double>, 0x3fd0000000000000,
+                        0x4030000000000000, 1 << 20);
+
+    // The reflection formulas lose the relative accuracy near the zeros of
+    // lgamma and digamma on the negative axis.
+    Verifier<double, uint64_t, 64, 16> d6, d7;
+    printf("\nmy_lgamma double, negative:");
+    d6.print_ulp_errors(my_lgamma, reference_lgamma<double>, 0x8000000000000001,
+                        0xc330000000000000, 1 << 18);
+    printf("\nmy_digamma double, negative:");
+    d7.print_ulp_errors(my_digamma, reference_digamma<double>, 0x8000000000000001,
+                        0xc330000000000000, 1 << 18);
+    if (verifier_interrupted) {
+        printf("Interrupted.\n");
+        return 1;
+    }
+
+    std::vector<float> iv = generate_test_vector<float>(0.01, 1000., 10000);
+    bench_throughput("my_lgamma   ", my_lgamma, iv, 1000);
+    bench_throughput("libm_lgammaf", libm_lgammaf, iv, 1000);
+    bench_throughput("my_digamma  ", my_digamma, iv, 1000);
+    bench_batch<float>("batch_my_lgamma   ", my_lgamma, iv, 1000);
+    bench_batch<float>("batch_libm_lgammaf", libm_lgammaf, iv, 1000);
+    bench_batch<float>("batch_my_digamma  ", my_digamma, iv, 1000);
+    std::vector<double> dv = generate_test_vector<double>(0.01, 1000., 10000);
+    bench_batch<double>("batch_my_lgamma_double ", my_lgamma, dv, 1000);
+    bench_batch<double>("batch_libm_lgamma      ", libm_lgamma, dv, 1000);
+    bench_batch<double>("batch_my_digamma_double", my_digamma, dv, 1000);
+    // Below 12, the double kernels take the branches of the scalar kernels.
+    std::vector<double> sv = generate_test_vector<double>(0.25, 12., 10000);
+    bench_batch<double>("batch_my_lgamma_double [0.25 .. 12) ", my_lgamma, sv, 1000);
+    bench_batch<double>("batch_libm_lgamma [0.25 .. 12)      ", libm_lgamma, sv, 1000);
+    bench_batch<double>("batch_my_digamma_double [0.25 .. 12)", my_digamma, sv, 1000);
+    return 0;
+}
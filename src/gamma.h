@@ -0,0 +1,420 @@
+#ifndef GAMMA_H
+#define GAMMA_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "domain.h"
+#include "double_double.h"
+#include "log_accurate.h"
+#include "log_dd.h"
+#include "poly.h"
+#include "util.h"
+
+// lgamma and digamma for float and double, built on the log kernels. Both
+// functions follow the same plan:
+//
+// 1. Near the zeros of the function, where the result is small and any
+//    formula with large terms cancels, a Taylor series around a fixed point:
+//    lgamma(2 + t) for t in [-0.5 .. 0.5], which covers the zeros at 1 and 2,
+//    and digamma(x0 + t), where x0 = 1.4616... is the positive root of
+//    digamma.
+// 2. Elsewhere, the recurrences lgamma(x + 1) = lgamma(x) + log(x) and
+//    digamma(x + 1) = digamma(x) + 1/x move x to a range where the other
+//    formulas work: up to the asymptotic (Stirling) series, or down to the
+//    Taylor series.
+// 3. The negative inputs go through the reflection formulas, which are
+//    accurate except near the zeros of the functions on the negative axis.
+//
+// The float kernels compute in double, with log_positive, and have no
+// branches, so the batch loops vectorize. The double kernels branch on the
+// range of x, and use the double-double log of log_dd.h where the result is
+// the small difference of large terms. Their batch loops vectorize only the
+// series of the large inputs, from 12 for lgamma and from 10 for digamma.
+// Below that, the double kernels are slower than libm: about 3.5x for
+// lgamma on [0.25 .. 12) in gamma.cc. On the samples of gamma.cc, the
+// double lgamma is within 0.6 ULP and digamma within 0.76 ULP on the
+// positive inputs.
+//
+// The special values: lgamma(0), lgamma(-n) and lgamma(+-inf) are +inf, like
+// libm. digamma(+-0) is -+inf, the limit from the side of the zero, and
+// digamma(-n) and digamma(-inf) are NaN.
+
+// The Taylor coefficients a_1 .. a_28 of lgamma(2 + t) = sum a_k t^k, where
+// a_1 = 1 - gamma and a_k = (-1)^k (zeta(k) - 1) / k. The series converges
+// like 4^-k on [-0.5 .. 0.5]. Generated with print_gamma_tables().
+inline constexpr double lgamma_2_series[28] = {
+    0x1.b0ee6072093cep-2,   0x1.4a34cc4a60fa6p-2,   -0x1.13e001a557607p-4,  0x1.51322ac7d8483p-6,
+    -0x1.e404fc218f5f2p-8,  0x1.7add6eadb6c3p-9,    -0x1.38ac5c2bf8e08p-10, 0x1.0b36af86396e9p-11,
+    -0x1.d3fd4c76d2fc8p-13, 0x1.a127b0f17d65ap-14,  -0x1.78de5bd7c81efp-15, 0x1.580dcee66eb02p-16,
+    -0x1.3cbc963ce2243p-17, 0x1.2597a39f34aacp-18,  -0x1.11b2eb7679541p-19, 0x1.0064cdeb22f0fp-20,
+    -0x1.e2600d93cfd2fp-22, 0x1.c76bbb3f07a4dp-23,  -0x1.af5a6cbbf8a97p-24, 0x1.99b93c2070b0fp-25,
+    -0x1.862c734df3eacp-26, 0x1.7469daccfadcdp-27,  -0x1.6434a8447aeadp-28, 0x1.555a877ffd2c3p-29,
+    -0x1.47b1679258d0ep-30, 0x1.3b15d2b2fc10cp-31,  -0x1.2f69a9fabe3ep-32,  0x1.24932a337434cp-33,
+};
+
+// The Taylor coefficients b_1 .. b_40 of digamma(x0 + t) = sum b_k t^k, where
+// b_k = (-1)^(k+1) zeta(k + 1, x0). The series converges like (t / x0)^k, or
+// 0.37^k on [1 .. 2]. Generated with print_gamma_tables().
+inline constexpr double digamma_root_series[40] = {
+    0x1.ef72bc8ee38acp-1,  -0x1.c563b54aa1a35p-2,  0x1.08b4294d50381p-2,  -0x1.4fc1317257da8p-3,
+    0x1.b9a5b6370f3abp-4,  -0x1.27baba261cc2cp-4,  0x1.8fce02b239ca7p-5,  -0x1.0fa7ec36a7d8fp-5,
+    0x1.723d6807edccp-6,   -0x1.f970508e1b6a2p-7,  0x1.5955caaa962f3p-7,  -0x1.d828079282eb8p-8,
+    0x1.42e1acf81d8dcp-8,  -0x1.b9afc7cee8a14p-9,  0x1.2e23345f79aafp-9,  -0x1.9d626f71d1f7ap-10,
+    0x1.1acebbd761089p-10, -0x1.82f6345c65b35p-11, 0x1.08bdae1a261d4p-11, -0x1.6a3fddea11304p-12,
+    0x1.efacab6fb8985p-13, -0x1.531f5dc5eb563p-13, 0x1.d0080f810fab5p-14, -0x1.3d7972688af67p-14,
+    0x1.b2691182c5c34p-15, -0x1.29357f7d6cb86p-15, 0x1.96ae4a8e32b49p-16, -0x1.163cc7373be8bp-16,
+    0x1.7cb8b3916fd29p-17, -0x1.047a1894e0fdep-17, 0x1.646b54f410bdfp-18, -0x1.e7b34a5b78a3cp-19,
+    0x1.4dab173747443p-19, -0x1.c891c9fca61dep-20, 0x1.385e9fcb1c6a8p-20, -0x1.ab6cff79188aap-21,
+    0x1.246e3329dab55p-21, -0x1.902471b2c8ebdp-22, 0x1.11c399dbd8e73p-22, -0x1.7699ba6292b3ep-23,
+};
+
+// The low parts of the first two coefficients of the series, for the
+// double-double evaluation of the double kernels.
+inline constexpr double lgamma_2_series_lo[2] = { 0x1.6cb90701fbfacp-58, 0x1.1873d8912200cp-56 };
+inline constexpr double digamma_root_series_lo[2] = { -0x1.3879eb97bf58dp-55, -0x1.c760306906dfep-56 };
+
+// The positive root of digamma, as the double-double value hi + lo.
+constexpr double DigammaRootHi = 0x1.762d86356be3fp+0;
+constexpr double DigammaRootLo = 0x1.b86a722197829p-54;
+
+// log(2 pi) / 2 and log(pi).
+constexpr double HalfLog2Pi = 0x1.d67f1c864beb5p-1;
+constexpr double LogPi = 0x1.250d048e7a1bdp+0;
+
+/// @return the sum of the first \p N terms of the series of lgamma(2 + t).
+template <size_t N> double lgamma_2_taylor(double t) {
+    return t * detail::horner_range<0, N, 1>(lgamma_2_series, t);
+}
+
+/// @return the sum of the first \p N terms of the series of digamma(x0 + t).
+template <size_t N> double digamma_root_taylor(double t) {
+    return t * detail::horner_range<0, N, 1>(digamma_root_series, t);
+}
+
+/// @return the sum c_1 t + c_2 t^2 + ... + c_N t^N of the series \p c, as a
+/// double-double value. The terms of degree 3 and above are below 1/8 of the
+/// result, so they are evaluated in double, and the first two terms are
+/// double-double Horner steps, with the low parts \p lo of the coefficients.
+template <size_t N> DoubleDouble taylor_dd(const double *c, const double *lo, double t) {
+    double rest = t * detail::horner_range<2, N - 2, 1>(c, t);
+    DoubleDouble q = two_sum(c[1], rest);
+    q.lo += lo[1];
+    q = dd_add(dd_mul(q, t), DoubleDouble{ c[0], lo[0] });
+    return dd_mul(q, t);
+}
+
+/// @return digamma(x0 + t) for the double-double value \p t.
+inline DoubleDouble digamma_root_dd(DoubleDouble t) {
+    DoubleDouble s = taylor_dd<40>(digamma_root_series, digamma_root_series_lo, t.hi);
+    s.lo = std::fma(digamma_root_series[0], t.lo, s.lo);
+    return s;
+}
+
+/// @return -\p a.
+inline DoubleDouble dd_neg(DoubleDouble a) { return { -a.hi, -a.lo }; }
+
+/// @return 1 / \p x as a double-double value. The remainder 1 - r * x is
+/// exact.
+inline DoubleDouble dd_recip(double x) {
+    double r = 1 / x;
+    return { r, std::fma(-r, x, 1) * r };
+}
+
+/// @return sin(pi * x). The reduction of x is exact, so the result is
+/// accurate near the integers, where sin(M_PI * x) is not.
+inline double sin_pi(double x) {
+    // x - 2 * round(x / 2) is exact, and in [-1 .. 1].
+    double r = x - 2 * std::nearbyint(0.5 * x);
+    // sin(pi * r) = sin(pi * (1 - r)), and 1 - |r| is exact.
+    double a = std::abs(r);
+    a = a > 0.5 ? 1 - a : a;
+    return std::copysign(std::sin(M_PI * a), r);
+}
+
+// The float kernels compute in double, and the error is a few ULPs of double,
+// so the results round correctly to float in almost all the cases. The parts
+// have no branches, and the positive finite floats are in their domain.
+
+/// @return lgamma(x) near the zeros at 1 and 2, for \p x in [0.5 .. 2.5).
+inline __attribute__((always_inline)) double lgamma_near_zeros(double x) {
+    // The series of lgamma(2 + t). Below 1.5 it is
+    // lgamma(x) = lgamma(x + 1) - log(x), and x - 1 is exact.
+    uint64_t below = -uint64_t(x < 1.5);
+    double t = x - blend(below, 1., 2.);
+    return lgamma_2_taylor<16>(t) - blend(below, log_positive(x), 0.);
+}
+
+/// @return lgamma(x) for a positive \p x away from the zeros.
+inline __attribute__((always_inline)) double lgamma_shifted(double x) {
+    // Shift x up to z >= 8 with
+    // lgamma(x) = lgamma(z) - log(x * (x + 1) * ... * (z - 1)), and use the
+    // Stirling series of lgamma(z).
+    double z = x, p = 1;
+    for (int i = 0; i < 8; i++) {
+        uint64_t small = -uint64_t(z < 8);
+        p *= blend(small, z, 1.);
+        z += blend(small, 1., 0.);
+    }
+    double r = 1 / z;
+    double correction = r * horner(r * r, 1. / 12, -1. / 360, 1. / 1260, -1. / 1680);
+    double stirling = ((z - 0.5) * log_positive(z) - z) + (HalfLog2Pi + correction);
+    return stirling - log_positive(p);
+}
+
+/// @return digamma(x) near the root, for \p x in [1 .. 2].
+inline __attribute__((always_inline)) double digamma_near_root(double x) {
+    return digamma_root_taylor<24>((x - DigammaRootHi) - DigammaRootLo);
+}
+
+/// @return digamma(x) for a positive \p x away from the root.
+inline __attribute__((always_inline)) double digamma_shifted(double x) {
+    // Shift x up to z >= 10 with
+    // digamma(x) = digamma(z) - (1/x + 1/(x + 1) + ... + 1/(z - 1)), and use
+    // the asymptotic series of digamma(z). The sum is accumulated as the
+    // fraction num / den, to save the divisions.
+    double z = x, num = 0, den = 1;
+    for (int i = 0; i < 10; i++) {
+        uint64_t small = -uint64_t(z < 10);
+        num = blend(small, std::fma(num, z, den), num);
+        den = blend(small, den * z, den);
+        z += blend(small, 1., 0.);
+    }
+    double r = 1 / z, r2 = r * r;
+    double asymptotic = log_positive(z) - (0.5 * r + r2 * horner(r2, 1. / 12, -1. / 120, 1. / 252, -1. / 240));
+    return asymptotic - num / den;
+}
+
+/// @return True if lgamma_near_zeros() computes lgamma(\p x).
+inline bool lgamma_is_near_zeros(double x) { return (x >= 0.5) & (x < 2.5); }
+/// @return True if digamma_near_root() computes digamma(\p x).
+inline bool digamma_is_near_root(double x) { return (x >= 1) & (x <= 2); }
+
+/// Compute lgamma(x) for a positive finite float \p x, in double, without
+/// branches, for the vectorized batch loop.
+inline __attribute__((always_inline)) double lgamma_positive(float x) {
+    return blend(-uint64_t(lgamma_is_near_zeros(x)), lgamma_near_zeros(x), lgamma_shifted(x));
+}
+
+/// Compute digamma(x) for a positive finite float \p x, like
+/// lgamma_positive().
+inline __attribute__((always_inline)) double digamma_positive(float x) {
+    return blend(-uint64_t(digamma_is_near_root(x)), digamma_near_root(x), digamma_shifted(x));
+}
+
+/// @return lgamma(x) for \p x in [12 .. 2^52), with the Stirling series. It
+/// has no branches, for the vectorized batch loop.
+inline __attribute__((always_inline)) double lgamma_stirling(double x) {
+    // (x - 0.5) * log(x) - x cancels a bit, so it is computed in
+    // double-double.
+    DoubleDouble s = dd_add(dd_mul(log_dd_normal(x, 0), x - 0.5), -x);
+    double r = 1 / x;
+    double correction =
+        r * horner(r * r, 1. / 12, -1. / 360, 1. / 1260, -1. / 1680, 1. / 1188, -691. / 360360, 1. / 156);
+    return s.hi + (s.lo + (HalfLog2Pi + correction));
+}
+
+/// @return digamma(x) for a finite \p x of at least 10, with the asymptotic
+/// series. It has no branches, like lgamma_stirling().
+inline __attribute__((always_inline)) double digamma_asymptotic(double x) {
+    double r = 1 / x, r2 = r * r;
+    double series = r2 * horner(r2, 1. / 12, -1. / 120, 1. / 252, -1. / 240, 1. / 132, -691. / 32760, 1. / 12);
+    return dd_add(log_dd_normal(x, 0), -(0.5 * r + series)).hi;
+}
+
+/// @return True if lgamma_stirling() computes lgamma(\p x).
+inline bool lgamma_is_stirling(double x) { return (x >= 12) & (x < 0x1p52); }
+/// @return True if digamma_asymptotic() computes digamma(\p x).
+inline bool digamma_is_asymptotic(double x) { return (x >= 10) & (x <= 0x1.fffffffffffffp1023); }
+
+/// Compute lgamma(x) for a positive double \p x, or +inf. Near the zeros,
+/// the series and the logs are double-double values, which are rounded once
+/// at the end.
+inline double lgamma_positive(double x) {
+    auto series = [](double t) { return taylor_dd<28>(lgamma_2_series, lgamma_2_series_lo, t); };
+    if (x < 0.5) {
+        // lgamma(x) = lgamma(x + 2) - log(x) - log1p(x). The error of the sum
+        // u = 1 + x is x - (u - 1), which is exact.
+        double u = 1 + x;
+        DoubleDouble log1p = dd_add(my_log_dd(u), (x - (u - 1)) / u);
+        return dd_add(dd_add(series(x), dd_neg(my_log_dd(x))), dd_neg(log1p)).hi;
+    }
+    if (x < 1.5) {
+        // lgamma(x) = lgamma(x + 1) - log(x), which cancels near 1.
+        return dd_add(series(x - 1), dd_neg(my_log_dd(x))).hi;
+    }
+    if (x < 2.5) {
+        return series(x - 2).hi;
+    }
+    if (x < 12) {
+        // Shift x down to y in [1.5 .. 2.5), with
+        // lgamma(x) = lgamma(y) + log(y * (y + 1) * ... * (x - 1)). The
+        // subtractions are exact.
+        DoubleDouble p = { 1, 0 };
+        double y = x;
+        while (y >= 2.5) {
+            y -= 1;
+            p = dd_mul(p, y);
+        }
+        DoubleDouble log_p = dd_add(my_log_dd(p.hi), p.lo / p.hi);
+        return dd_add(series(y - 2), log_p).hi;
+    }
+    if (x < 0x1p52) {
+        return lgamma_stirling(x);
+    }
+    // x - 0.5 is not exact, so the product is split as
+    // x * (log(x) - 1) + (log(2 pi) - log(x)) / 2, and the correction is below
+    // the ULP. Overflows to +inf above 2^1017.
+    if (std::isinf(x)) {
+        return x;
+    }
+    DoubleDouble l = my_log_dd(x);
+    DoubleDouble s = dd_add(l, -1.);
+    return std::fma(x, s.hi, std::fma(x, s.lo, HalfLog2Pi - 0.5 * l.hi));
+}
+
+/// Compute digamma(x) for a positive double \p x, or +inf.
+inline double digamma_positive(double x) {
+    if (x < 0x1p-60) {
+        // digamma(x) = -1/x - gamma + O(x), where gamma is below the ULP. This
+        // also keeps 1/x of the denormals from overflowing in dd_recip().
+        return -1 / x;
+    }
+    if (x < 1) {
+        // digamma(x) = digamma(x + 1) - 1/x. The series variable is
+        // x + (1 - x0), where 1 - x0 is exact.
+        DoubleDouble t = two_sum(x, 1 - DigammaRootHi);
+        t = fast_two_sum(t.hi, t.lo - DigammaRootLo);
+        return dd_add(digamma_root_dd(t), dd_neg(dd_recip(x))).hi;
+    }
+    if (x < 10) {
+        // Shift x down to y in [1 .. 2], with
+        // digamma(x) = digamma(y) + 1/y + 1/(y + 1) + ... + 1/(x - 1). The
+        // subtractions are exact.
+        DoubleDouble sum = { 0, 0 };
+        double y = x;
+        while (y > 2) {
+            y -= 1;
+            sum = dd_add(sum, dd_recip(y));
+        }
+        DoubleDouble t = fast_two_sum(y - DigammaRootHi, -DigammaRootLo);
+        return dd_add(digamma_root_dd(t), sum).hi;
+    }
+    if (std::isinf(x)) {
+        return x;
+    }
+    return digamma_asymptotic(x);
+}
+
+/// @return lgamma(x), the log of the absolute value of the gamma function.
+KERNEL_API double my_lgamma(double x) {
+    if (x > 0) {
+        return lgamma_positive(x);
+    }
+    if (std::isnan(x)) {
+        return x;
+    }
+    // Zero, the negative integers and -inf are poles.
+    if (x == std::floor(x)) {
+        return INFINITY;
+    }
+    // The reflection formula lgamma(x) = log(pi / |sin(pi x)|) - lgamma(1 - x).
+    return (LogPi - my_log_double(std::abs(sin_pi(x)))) - lgamma_positive(1 - x);
+}
+
+/// @return digamma(x), the derivative of lgamma.
+KERNEL_API double my_digamma(double x) {
+    if (x > 0) {
+        return digamma_positive(x);
+    }
+    if (x == 0) {
+        return -std::copysign(INFINITY, x);
+    }
+    if (std::isnan(x)) {
+        return x;
+    }
+    if (x == std::floor(x)) {
+        return NAN;
+    }
+    // The reflection formula digamma(x) = digamma(1 - x) - pi / tan(pi x),
+    // where tan has the period 1, and x - round(x) is exact.
+    return digamma_positive(1 - x) - M_PI / std::tan(M_PI * (x - std::nearbyint(x)));
+}
+
+/// @return lgamma(x), within 1 ULP.
+KERNEL_API float my_lgamma(float x) {
+    if (!Positive::contains(x)) {
+        return float(my_lgamma(double(x)));
+    }
+    return float(lgamma_is_near_zeros(x) ? lgamma_near_zeros(x) : lgamma_shifted(x));
+}
+
+/// @return digamma(x), within 1 ULP.
+KERNEL_API float my_digamma(float x) {
+    if (!Positive::contains(x)) {
+        return float(my_digamma(double(x)));
+    }
+    return float(digamma_is_near_root(x) ? digamma_near_root(x) : digamma_shifted(x));
+}
+
+/// Compute \p out[i] = lgamma(\p in[i]) for \p n elements. The arrays must not
+/// overlap.
+KERNEL_API void my_lgamma(const float *in, float *out, size_t n) {
+    // The first loop vectorizes, and the second one fixes the inputs that are
+    // not positive and finite.
+    for (size_t i = 0; i < n; i++) {
+        out[i] = float(lgamma_positive(in[i]));
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (!Positive::contains(in[i])) {
+            out[i] = float(my_lgamma(double(in[i])));
+        }
+    }
+}
+
+/// Compute \p out[i] = digamma(\p in[i]) for \p n elements. The arrays must not
+/// overlap.
+KERNEL_API void my_digamma(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = float(digamma_positive(in[i]));
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (!Positive::contains(in[i])) {
+            out[i] = float(my_digamma(double(in[i])));
+        }
+    }
+}
+
+/// Compute \p out[i] = lgamma(\p in[i]) for \p n elements. The arrays must not
+/// overlap.
+KERNEL_API void my_lgamma(const double *in, double *out, size_t n) {
+    // The first loop vectorizes on the Stirling series, and the second one
+    // fixes the inputs below 12 with the branches of the scalar kernel. The
+    // first loop moves these inputs to 12, which keeps them in the domain of
+    // the series. The comparison is false for NaN.
+    for (size_t i = 0; i < n; i++) {
+        out[i] = lgamma_stirling(blend(-uint64_t(lgamma_is_stirling(in[i])), in[i], 12.));
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (!lgamma_is_stirling(in[i])) {
+            out[i] = my_lgamma(in[i]);
+        }
+    }
+}
+
+/// Compute \p out[i] = digamma(\p in[i]) for \p n elements. The arrays must
+/// not overlap.
+KERNEL_API void my_digamma(const double *in, double *out, size_t n) {
+    // Like my_lgamma, on the asymptotic series from 10.
+    for (size_t i = 0; i < n; i++) {
+        out[i] = digamma_asymptotic(blend(-uint64_t(digamma_is_asymptotic(in[i])), in[i], 10.));
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (!digamma_is_asymptotic(in[i])) {
+            out[i] = my_digamma(in[i]);
+        }
+    }
+}
+
+#endif // GAMMA_H
@@ -0,0 +1,148 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "exp_accurate.h"
+#include "half.h"
+#include "log_accurate.h"
+#include "util.h"
+
+/// @return the distance between two half-precision bit patterns.
+unsigned half_ulp_difference(uint16_t a, uint16_t b, float fa, float fb) {
+    if (a == b || (std::isnan(fa) && std::isnan(fb))) {
+        return 0;
+    }
+    return (a > b) ? (a - b) : (b - a);
+}
+
+/// Compare \p handle against the libm double function \p ref on all the 2^16
+/// inputs.
+template <class Format>
+void print_half_ulp_deltas(const char *name, uint16_t (*handle)(uint16_t), double (*ref)(double)) {
+    Histogram<4> hist;
+    for (unsigned i = 0; i < (1 << 16); i++) {
+        double x = Format::to_float(uint16_t(i));
+        uint16_t r1 = handle(uint16_t(i));
+        uint16_t r2 = Format::from_double(ref(x));
+        hist.add(half_ulp_difference(r1, r2, Format::to_float(r1), Format::to_float(r2)));
+    }
+    std::string message = std::string("\nULP delta (") + name + "):\n";
+    hist.dump(message.c_str(), 1 << 16);
+}
+
+// Convert to float and call my_log or my_exp, which is what the callers do
+// today.
+template <class Format> uint16_t log_half_float(uint16_t h) {
+    return Format::from_float(my_log(Format::to_float(h)));
+}
+template <class Format> uint16_t exp_half_float(uint16_t h) {
+    return Format::from_float(my_exp(Format::to_float(h)));
+}
+template <class Format>
+void __attribute__((noinline)) log_half_float(const uint16_t *in, uint16_t *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = log_half_float<Format>(in[i]);
+    }
+}
+template <class Format>
+void __attribute__((noinline)) exp_half_float(const uint16_t *in, uint16_t *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = exp_half_float<Format>(in[i]);
+    }
+}
+
+void check() {
+    // Check the conversions on all the values.
+    for (unsigned i = 0; i < (1 << 16); i++) {
+        float x = FP16::to_float(uint16_t(i));
+        assert(std::isnan(x) || FP16::from_float(x) == i);
+        float y = BF16::to_float(uint16_t(i));
+        assert(std::isnan(y) || BF16::from_float(y) == i);
+    }
+    // Ties round to even.
+    assert(FP16::from_float(1 + 0x1p-11f) == 0x3c00);
+    assert(FP16::from_float(1 + 3 * 0x1p-11f) == 0x3c02);
+    assert(FP16::from_float(65519.f) == 0x7bff);
+    assert(FP16::from_float(65520.f) == 0x7c00);
+    assert(FP16::from_float(0x1p-25f) == 0);
+    assert(FP16::from_float(0x1p-24f) == 1);
+    assert(BF16::from_float(1 + 0x1p-8f) == 0x3f80);
+    assert(BF16::from_float(1 + 3 * 0x1p-8f) == 0x3f82);
+    // Rounding from double does not go through the nearest float, which
+    // would be a tie here.
+    assert(FP16::from_double(1 + 0x1p-11 + 0x1p-40) == 0x3c01);
+    assert(FP16::from_double(-(1 + 0x1p-11 + 0x1p-40)) == 0xbc01);
+    assert(FP16::from_double(1 + 0x1p-11) == 0x3c00);
+    assert(FP16::from_double(1e300) == 0x7c00 && FP16::from_double(1e-300) == 0);
+    assert(BF16::from_double(1 + 0x1p-8 + 0x1p-40) == 0x3f81);
+    assert(std::isnan(FP16::to_float(FP16::from_double(NAN))));
+    for (unsigned i = 0; i < (1 << 16); i++) {
+        float x = FP16::to_float(uint16_t(i));
+        assert(std::isnan(x) || FP16::from_double(x) == i);
+        float y = BF16::to_float(uint16_t(i));
+        assert(std::isnan(y) || BF16::from_double(y) == i);
+    }
+}
+
+/// Benchmark the batch kernel \p handle on \p n random inputs in the range
+/// [start .. end]. The working set of the inputs and outputs is 4n bytes.
+template <class Format>
+void bench_half(const std::string &name, void (*handle)(const uint16_t *, uint16_t *, size_t),
+                float start, float end, size_t n) {
+    std::vector<float> fv = generate_test_vector<float>(start, end, n);
+    std::vector<uint16_t> in(n);
+    std::vector<uint16_t> out(n);
+    for (size_t i = 0; i < n; i++) {
+        in[i] = Format::from_float(fv[i]);
+    }
+    // Warm up the caches and the tables.
+    handle(in.data(), out.data(), n);
+
+    // Process about 2^26 elements in total.
+    size_t iterations = std::max<size_t>(1, (1 << 26) / n);
+    auto t1 = high_resolution_clock::now();
+    unsigned sum = 0;
+    for (size_t iter = 0; iter < iterations; iter++) {
+        handle(in.data(), out.data(), n);
+        sum += out[iter % n];
+    }
+    auto t2 = high_resolution_clock::now();
+    double ns = duration_cast<duration<double, std::nano>>(t2 - t1).count();
+    printf("name = %-16s, working set = %6zuKB, sum = %u, time = %.2fns/elem\n", name.c_str(),
+           (4 * n) >> 10, sum, ns / double(iterations * n));
+}
+
+int main(int argc, char **argv) {
+    check();
+    print_half_ulp_deltas<FP16>("log fp16", log_half<FP16>, log);
+    print_half_ulp_deltas<FP16>("log fp16 table", log_half_table<FP16>, log);
+    print_half_ulp_deltas<FP16>("exp fp16", exp_half<FP16>, exp);
+    print_half_ulp_deltas<FP16>("exp fp16 table", exp_half_table<FP16>, exp);
+    print_half_ulp_deltas<BF16>("log bf16", log_half<BF16>, log);
+    print_half_ulp_deltas<BF16>("log bf16 table", log_half_table<BF16>, log);
+    print_half_ulp_deltas<BF16>("exp bf16", exp_half<BF16>, exp);
+    print_half_ulp_deltas<BF16>("exp bf16 table", exp_half_table<BF16>, exp);
+
+    // The working sets fit in L1, L2, L3 and main memory. The 128KB table of
+    // each kernel competes with the inputs for the cache.
+    for (size_t n : { 1 << 12, 1 << 16, 1 << 20, 1 << 25 }) {
+        printf("\n");
+        bench_half<FP16>("log_fp16_float", log_half_float<FP16>, 0.01, 100, n);
+        bench_half<FP16>("log_fp16", log_half<FP16>, 0.01, 100, n);
+        bench_half<FP16>("log_fp16_table", log_half_table<FP16>, 0.01, 100, n);
+        bench_half<FP16>("exp_fp16_float", exp_half_float<FP16>, -10, 10, n);
+        bench_half<FP16>("exp_fp16", exp_half<FP16>, -10, 10, n);
+        bench_half<FP16>("exp_fp16_table", exp_half_table<FP16>, -10, 10, n);
+        bench_half<BF16>("log_bf16_float", log_half_float<BF16>, 0.01, 100, n);
+        bench_half<BF16>("log_bf16", log_half<BF16>, 0.01, 100, n);
+        bench_half<BF16>("log_bf16_table", log_half_table<BF16>, 0.01, 100, n);
+        bench_half<BF16>("exp_bf16_float", exp_half_float<BF16>, -10, 10, n);
+        bench_half<BF16>("exp_bf16", exp_half<BF16>, -10, 10, n);
+        bench_half<BF16>("exp_bf16_table", exp_half_table<BF16>, -10, 10, n);
+    }
+    return 0;
+}
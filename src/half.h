@@ -0,0 +1,223 @@
+#ifndef HALF_H
+#define HALF_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "util.h"
+
+/// Round \p x to float with round-to-odd: truncate, and set the last bit of
+/// the mantissa if the result is inexact. Rounding the result again to a
+/// format with at least two fewer mantissa bits gives the same result as
+/// rounding \p x directly, which rounding to nearest twice does not.
+inline float round_to_odd(double x) {
+    float f = float(x);
+    uint32_t bits = bit_cast<uint32_t, float>(f);
+    // The comparisons are false for NaN.
+    bits -= uint32_t(std::abs(double(f)) > std::abs(x));
+    bits |= uint32_t(double(f) != x && x == x);
+    return bit_cast<float, uint32_t>(bits);
+}
+
+/// The IEEE half-precision format: 1 sign bit, 5 exponent bits and 10
+/// mantissa bits. The conversions select the special cases without branches,
+/// so that the batch kernels vectorize.
+struct FP16 {
+    static float to_float(uint16_t h) {
+        uint32_t sign = uint32_t(h & 0x8000) << 16;
+        uint32_t shifted = uint32_t(h & 0x7fff) << 13;
+        uint32_t exponent = shifted & 0x0f800000;
+        // Change the exponent bias from 15 to 127.
+        uint32_t normal = shifted + ((127 - 15) << 23);
+        // Inf and NaN keep the maximal exponent.
+        normal = exponent == 0x0f800000 ? normal + ((128 - 16) << 23) : normal;
+        // Zero and the denormals: place the mantissa under the exponent of
+        // 2^-14 and subtract the implicit one.
+        float denormal = bit_cast<float, uint32_t>(normal + (1 << 23)) - 0x1p-14f;
+        uint32_t res = exponent == 0 ? bit_cast<uint32_t, float>(denormal) : normal;
+        return bit_cast<float, uint32_t>(res | sign);
+    }
+
+    /// Round \p x to the nearest half-precision value, with ties to even.
+    static uint16_t from_float(float x) {
+        uint32_t bits = bit_cast<uint32_t, float>(x);
+        uint32_t sign = (bits >> 16) & 0x8000;
+        uint32_t abs = bits & 0x7fffffff;
+
+        // Change the exponent bias, and round the mantissa from 23 to 10 bits.
+        uint32_t normal = abs - (112u << 23) + 0xfff + ((abs >> 13) & 1);
+        normal >>= 13;
+        // Values below 2^-14 become denormals. Adding 0.5 shifts the mantissa
+        // to the right place, and the addition rounds it to nearest even.
+        float shifted = bit_cast<float, uint32_t>(abs) + 0.5f;
+        uint32_t denormal = bit_cast<uint32_t, float>(shifted) - bit_cast<uint32_t, float>(0.5f);
+        // Values above 65520 round to Inf, and NaN stays quiet.
+        uint32_t special = abs > 0x7f800000 ? 0x7e00 : 0x7c00;
+
+        uint32_t res = abs < 0x38800000 ? denormal : normal;
+        res = abs >= 0x477ff000 ? special : res;
+        return uint16_t(res | sign);
+    }
+
+    /// Round \p x to the nearest half-precision value, with ties to even.
+    static uint16_t from_double(double x) { return from_float(round_to_odd(x)); }
+};
+
+/// The bfloat16 format, which is the top 16 bits of a float.
+struct BF16 {
+    static float to_float(uint16_t h) { return bit_cast<float, uint32_t>(uint32_t(h) << 16); }
+
+    /// Round \p x to the nearest bfloat16 value, with ties to even.
+    static uint16_t from_float(float x) {
+        uint32_t bits = bit_cast<uint32_t, float>(x);
+        if ((bits & 0x7fffffff) > 0x7f800000) {
+            // Keep the NaN quiet.
+            return uint16_t(bits >> 16) | 0x40;
+        }
+        bits += 0x7fff + ((bits >> 16) & 1);
+        return uint16_t(bits >> 16);
+    }
+
+    /// Round \p x to the nearest bfloat16 value, with ties to even.
+    static uint16_t from_double(double x) { return from_float(round_to_odd(x)); }
+};
+
+/// Compute log(x) in float with a reduced-precision polynomial. This is the
+/// reduction of my_log to m in [sqrt(2)/2 .. sqrt(2)], but instead of the
+/// lookup tables, which don't vectorize, log(m) = 2*atanh(s) for
+/// s = (m-1)/(m+1) in [-0.172 .. 0.172] is approximated by an odd polynomial
+/// of degree 7, with an error below 2^-25. The special values are selected at
+/// the end, without branches.
+inline float log_f32_reduced(float x) {
+    // Scale the denormals of bfloat16 to the normal range.
+    bool denormal = x < 0x1p-126f;
+    float xs = denormal ? x * 0x1p23f : x;
+    uint32_t bits = bit_cast<uint32_t, float>(xs);
+    uint32_t mantissa = bits & 0x7fffff;
+    int E = int((bits >> 23) & 0xff) - 127 - 23 * int(denormal);
+
+    // Reduce the range of m to [sqrt(2)/2 -- sqrt(2)], without a branch.
+    uint32_t big = mantissa > 0x3504f3;
+    E = E + int(big);
+    float m = bit_cast<float, uint32_t>((mantissa | 0x3f800000) - (big << 23));
+
+    float s = (m - 1) / (m + 1);
+    float s2 = s * s;
+    float ln_m = 2 * s * (1 + s2 * (1.f / 3 + s2 * (1.f / 5 + s2 * (1.f / 7))));
+    float res = E * 0.693147181f + ln_m;
+
+    // Handle the special values. Zero, Inf, NaN and the negative numbers all
+    // wrap to the top of the range in the mask below. GCC turns a select of
+    // the float result into a branch, so blend the bits of the results.
+    uint32_t xb = bit_cast<uint32_t, float>(x);
+    uint32_t special = xb; // +Inf and NaN return x.
+    special = (xb << 1) == 0 ? 0xff800000 : special; // log(+-0) = -Inf.
+    special = xb > 0x80000000 ? 0x7fc00000 : special; // log(-x) = NaN.
+    uint32_t mask = -uint32_t(xb - 1 >= 0x7f7fffff);
+    uint32_t rb = bit_cast<uint32_t, float>(res);
+    return bit_cast<float, uint32_t>((rb & ~mask) | (special & mask));
+}
+
+/// Compute exp(x) in float with a reduced-precision polynomial. The input is
+/// split into x = k*log(2) + f, and a degree 5 Taylor polynomial approximates
+/// exp(f) for f in [-0.35 .. 0.35], with an error below 2^-18.
+inline float exp_f32_reduced(float x) {
+    // Outside of this range exp overflows or underflows anyway.
+    float xc = std::min(std::max(x, -104.f), 89.f);
+
+    float k = std::nearbyint(xc * 1.44269504f);
+    // Subtract k*log(2) in two parts, to keep the bits of the residual.
+    float f = std::fma(-k, 0.693145752f, xc);
+    f = std::fma(-k, 1.42860677e-6f, f);
+    float p = 1 + f * (1 + f * (0.5f + f * (1.f / 6 + f * (1.f / 24 + f * (1.f / 120)))));
+
+    // Scale by 2^k in two steps, because 2^k is not a normal float for all k
+    // in [-150 .. 129].
+    int ki = int(k);
+    int k1 = ki / 2;
+    int k2 = ki - k1;
+    float s1 = bit_cast<float, uint32_t>(uint32_t(k1 + 127) << 23);
+    float s2 = bit_cast<float, uint32_t>(uint32_t(k2 + 127) << 23);
+    float res = p * s1 * s2;
+    return x == x ? res : x;
+}
+
+/// Compute log(h) for the half-precision value \p h in the format \p Format.
+template <class Format> uint16_t log_half(uint16_t h) {
+    return Format::from_float(log_f32_reduced(Format::to_float(h)));
+}
+
+/// Compute exp(h) for the half-precision value \p h in the format \p Format.
+template <class Format> uint16_t exp_half(uint16_t h) {
+    return Format::from_float(exp_f32_reduced(Format::to_float(h)));
+}
+
+/// Selects the function of a HalfTable.
+enum class HalfFn { Log, Exp };
+
+/// A table with the results of log or exp for all the 2^16 inputs of a
+/// half-precision format. The table is 128KB, and it is computed once, on
+/// first use, with the libm double functions. The results are rounded from
+/// double to the format directly.
+template <class Format, HalfFn Fn> struct HalfTable {
+    uint16_t data_[1 << 16];
+
+    HalfTable() {
+        for (unsigned i = 0; i < (1 << 16); i++) {
+            double x = Format::to_float(uint16_t(i));
+            data_[i] = Format::from_double(Fn == HalfFn::Log ? log(x) : exp(x));
+        }
+    }
+    static const uint16_t *get() {
+        static HalfTable table;
+        return table.data_;
+    }
+};
+
+/// Compute log(h) for the half-precision value \p h with a table lookup.
+template <class Format> uint16_t log_half_table(uint16_t h) {
+    return HalfTable<Format, HalfFn::Log>::get()[h];
+}
+
+/// Compute exp(h) for the half-precision value \p h with a table lookup.
+template <class Format> uint16_t exp_half_table(uint16_t h) {
+    return HalfTable<Format, HalfFn::Exp>::get()[h];
+}
+
+/// Compute \p out[i] = log(\p in[i]) for \p n values, with the polynomial.
+template <class Format>
+KERNEL_API void log_half(const uint16_t *in, uint16_t *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = log_half<Format>(in[i]);
+    }
+}
+
+/// Compute \p out[i] = exp(\p in[i]) for \p n values, with the polynomial.
+template <class Format>
+KERNEL_API void exp_half(const uint16_t *in, uint16_t *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = exp_half<Format>(in[i]);
+    }
+}
+
+/// Compute \p out[i] = log(\p in[i]) for \p n values, with the table.
+template <class Format>
+KERNEL_API void log_half_table(const uint16_t *in, uint16_t *out, size_t n) {
+    const uint16_t *table = HalfTable<Format, HalfFn::Log>::get();
+    for (size_t i = 0; i < n; i++) {
+        out[i] = table[in[i]];
+    }
+}
+
+/// Compute \p out[i] = exp(\p in[i]) for \p n values, with the table.
+template <class Format>
+KERNEL_API void exp_half_table(const uint16_t *in, uint16_t *out, size_t n) {
+    const uint16_t *table = HalfTable<Format, HalfFn::Exp>::get();
+    for (size_t i = 0; i < n; i++) {
+        out[i] = table[in[i]];
+    }
+}
+
+#endif // HALF_H
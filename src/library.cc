@@ -0,0 +1,71 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "fast_log.h"
+#include "util.h"
+
+// The header-only library, from the point of view of a service that links
+// two translation units, this one and library_calls.cc, which both include
+// fast_log.h. Unlike the benchmarks, this program is built without
+// NOINLINE_KERNELS, so the kernels inline into the loops of the callers.
+
+void log_loop(const float *in, float *out, size_t n);
+void exp_loop(const float *in, float *out, size_t n);
+double fast_log_sum(const double *in, size_t n);
+
+// The cost of a call per element, which is what the callers paid when the
+// kernels were out of line.
+float __attribute__((noinline)) call_my_log(float x) { return my_log(x); }
+float __attribute__((noinline)) call_my_exp(float x) { return my_exp(x); }
+
+void __attribute__((noinline)) call_log_loop(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = call_my_log(in[i]);
+    }
+}
+
+void __attribute__((noinline)) call_exp_loop(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = call_my_exp(in[i]);
+    }
+}
+
+void check() {
+    // The inlined kernels return the same results as the calls.
+    std::vector<float> in = generate_test_vector<float>(-100, 100, 1000);
+    in.insert(in.end(), { 0.f, -0.f, INFINITY, -INFINITY, NAN, 0x1p-149f, 1.f });
+    std::vector<float> out(in.size());
+    log_loop(in.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); i++) {
+        float r = call_my_log(in[i]);
+        assert(memcmp(&r, &out[i], sizeof(float)) == 0);
+    }
+    exp_loop(in.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); i++) {
+        float r = call_my_exp(in[i]);
+        assert(memcmp(&r, &out[i], sizeof(float)) == 0);
+    }
+
+    std::vector<double> dv = generate_test_vector(0.5, 10., 1000);
+    double sum = 0;
+    for (double x : dv) {
+        sum += fastlog2(x);
+    }
+    assert(sum == fast_log_sum(dv.data(), dv.size()));
+}
+
+int main(int argc, char **argv) {
+    check();
+
+    std::vector<float> iv = generate_test_vector<float>(0.01, 1000., 10000);
+    std::vector<float> ev = generate_test_vector<float>(-20, 20, 10000);
+    bench_batch("inline_my_log", log_loop, iv);
+    bench_batch("call_my_log  ", call_log_loop, iv);
+    bench_batch("inline_my_exp", exp_loop, ev);
+    bench_batch("call_my_exp  ", call_exp_loop, ev);
+    return 0;
+}
@@ -0,0 +1,28 @@
+#include <cstddef>
+
+#include "fast_log.h"
+
+// The second translation unit of the library program. It includes all the
+// kernels, like library.cc does, and the program links only if the headers
+// define no symbols outside of the inline functions and tables.
+
+// A call site in a service: the kernels inline into the loops.
+void log_loop(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = my_log(in[i]);
+    }
+}
+
+void exp_loop(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = my_exp(in[i]);
+    }
+}
+
+double fast_log_sum(const double *in, size_t n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += fastlog2(in[i]);
+    }
+    return sum;
+}
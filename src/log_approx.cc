@@ -1,4 +1,5 @@
 #include <cassert>
+#include <cfloat>
 #include <cmath>
 #include <cstring>
 #include <iostream>
@@ -7,109 +8,98 @@
 #include <string>
 #include <vector>
 
+#include "log_approx.h"
+#include "poly.h"
+#include "reference.h"
 #include "util.h"
 
 double __attribute__((noinline)) nop(double x) { return 0.00001; }
 
-/// @returns the exponent and a normalized mantissa with the relationship:
-/// [a * 2^b] = x
-std::pair<double, int> my_frexp(double x) {
-    uint64_t bits = bit_cast<uint64_t, double>(x);
-    if (bits == 0) {
-        return { 0., 0 };
-    }
-    // See:
-    // https://en.wikipedia.org/wiki/IEEE_754#Basic_and_interchange_formats
-
-    // Extract the 52-bit mantissa field.
-    uint64_t mantissa = bits & 0xFFFFFFFFFFFFF;
-    bits >>= 52;
-
-    // Extract the 11-bit exponent field, and add the bias.
-    int exponent = int(bits & 0x7ff) - 1023;
-    bits >>= 11;
-
-    // Extract the sign bit.
-    uint64_t sign = bits;
-    bits >>= 1;
-
-    // Construct the normalized double;
-    uint64_t res = sign;
-    res <<= 11;
-    res |= 1023 - 1;
-    res <<= 52;
-    res |= mantissa;
-
-    double frac = bit_cast<double, uint64_t>(res);
-    return { frac, exponent + 1 };
-}
-
-double __attribute__((noinline)) fastlog2(double x) {
-
-    /// Extract the fraction, and the power-of-two exponent.
-
-    auto a = my_frexp(x);
-    x = a.first;
-    int pow2 = a.second;
-
-    // Use a 4-part polynom to approximate log2(x);
-    double c[] = { 1.33755322, -4.42852392, 6.30371424, -3.21430967 };
-    double log2 = 0.6931471805599453;
-
-    // Use Horner's method to evaluate the polynomial.
-    double val = c[3] + x * (c[2] + x * (c[1] + x * (c[0])));
-
-    // Compute log2(x), and convert the result to base-e.
-    return log2 * (pow2 + val);
-}
-
-// Find the max error.
+// Find the max error, compared to the double-double reference.
 void validate_error(const std::vector<double> &iv, double max_range = 20.0,
                     int iterations = 10000) {
-    double max_error = 0;
-    double error_val = 0;
-    unsigned validated = 0;
-    // Validate a sequence of numbers.
+    // Validate a sequence of numbers, and the pre-computed random numbers.
+    std::vector<double> values;
     for (int i = 1; i < iterations; i++) {
-        validated++;
-        double val = ((max_range * i) / iterations);
-        double err = std::abs(log(val) - fastlog2(val));
-        if (err > max_error) {
-            error_val = val;
-            max_error = err;
-        }
+        values.push_back((max_range * i) / iterations);
     }
+    values.insert(values.end(), iv.begin(), iv.end());
+    std::vector<DoubleDouble> ref(values.size());
+    reference_log(values.data(), ref.data(), values.size());
 
-    // Validate the pre-computed random numbers.
-    for (auto elem : iv) {
-        validated++;
-        double err = std::abs(log(elem) - fastlog2(elem));
+    double max_error = 0;
+    double error_val = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        double err = std::abs((fastlog2(values[i]) - ref[i].hi) - ref[i].lo);
         if (err > max_error) {
-            error_val = elem;
+            error_val = values[i];
             max_error = err;
         }
     }
 
-    std::cout << "Tested " << validated << " values [0.." << max_range << "]\n";
+    std::cout << "Tested " << values.size() << " values [0.." << max_range << "]\n";
     std::cout << "Max error " << max_error << " at " << error_val << "\n";
     std::cout << "# " << log(error_val) << " vs " << fastlog2(error_val) << "\n";
 }
 
-// Check if the function is monolithic.
-void validate_monotonic(double max_range = 20.0, int iterations = 10000) {
-    double prev = fastlog2(0);
-    unsigned non_monotonic = 0;
-    for (int i = 1; i < iterations; i++) {
-        double val = ((max_range * i) / iterations);
-        val = fastlog2(val);
-        if (prev > val) {
-            non_monotonic += 1;
+/// Print the correction table of mitchell_log.
+void print_mitchell_table() {
+    auto correction = [](double m) { return std::log2(1 + m) - m; };
+    // The largest error of the linear interpolation between the points.
+    double max_err = 0;
+    for (int i = 0; i < 64; i++) {
+        double a = correction(i / 64.), b = correction((i + 1) / 64.);
+        for (int k = 1; k < 1000; k++) {
+            double chord = a + (b - a) * k / 1000;
+            max_err = std::max(max_err, correction((i + k / 1000.) / 64) - chord);
+        }
+    }
+    printf("inline constexpr int32_t mitchell_table[65] = {");
+    for (int i = 0; i <= 64; i++) {
+        if (i % 13 == 0) {
+            printf("\n   ");
         }
+        printf(" %ld,", std::lround((correction(i / 64.) + max_err / 2) * 65536));
+    }
+    printf("\n};\n");
+}
+
+/// @return the number of steps where \p f decreases, on all the non-negative
+/// floats in increasing order, from +0 to +inf.
+template <class Fn> uint64_t count_non_monotonic(Fn f) {
+    uint64_t count = 0;
+    auto prev = f(0.f);
+    for (uint32_t bits = 1; bits <= 0x7f800000; bits++) {
+        auto val = f(bit_cast<float, uint32_t>(bits));
+        count += val < prev;
         prev = val;
     }
+    return count;
+}
 
-    std::cout << "Tested " << iterations << " values [0.." << max_range << "]\n";
-    std::cout << "Found " << non_monotonic << " non-monotinic values\n";
+// Check if the functions are monotonic, on every non-negative float.
+void validate_monotonic() {
+    uint64_t fast = count_non_monotonic([](float x) { return fastlog2(double(x)); });
+    std::cout << "fastlog2: found " << fast << " non-monotonic steps\n";
+    uint64_t mitchell = count_non_monotonic([](float x) { return mitchell_log(x); });
+    std::cout << "mitchell_log: found " << mitchell << " non-monotonic steps\n";
+    assert(mitchell == 0);
+}
+
+/// Find the max absolute error of mitchell_log, on every normal float.
+void validate_mitchell_error() {
+    double max_error = 0;
+    float error_val = 0;
+    for (uint32_t bits = 0x00800000; bits < 0x7f800000; bits++) {
+        float x = bit_cast<float, uint32_t>(bits);
+        double err = std::abs(mitchell_log(x) - std::log(double(x)));
+        if (err > max_error) {
+            max_error = err;
+            error_val = x;
+        }
+    }
+    std::cout << "mitchell_log: max error " << max_error << " at " << error_val << "\n";
+    assert(max_error < 5e-5);
 }
 
 void check() {
@@ -121,6 +111,28 @@ void check() {
     assert(b.first == 0.8 && b.second == 2);
     assert(c.first == -0.625 && c.second == 4);
     assert(d.first == 0.5 && d.second == 17);
+
+    // The powers of two are close to exact, -0 is +0, and the negative inputs
+    // are NaN.
+    assert(std::abs(mitchell_log(1.f)) < 2e-5 && std::abs(mitchell_log(8.f) - std::log(8.)) < 2e-5);
+    assert(mitchell_log(-0.f) == mitchell_log(0.f));
+    assert(std::isnan(mitchell_log(-1.f)) && std::isnan(mitchell_log(-INFINITY)));
+    assert(std::isnan(mitchell_log(NAN)));
+    assert(mitchell_log(0.f) < mitchell_log(0x1p-140f) && mitchell_log(FLT_MAX) < mitchell_log(INFINITY));
+    // The ends that the doc of mitchell_log lists, and a run of 128 floats
+    // with the same key.
+    assert(mitchell_log(0.f) == mitchell_log(0x1p-149f) && std::abs(mitchell_log(0.f) + 88.03f) < 0.01f);
+    assert(std::abs(mitchell_log(INFINITY) - 88.72f) < 0.01f);
+    assert(mitchell_log(1.f) == mitchell_log(1 + 127 * 0x1p-23f));
+    assert(mitchell_log(1.f) < mitchell_log(1 + 128 * 0x1p-23f));
+
+    // The batch kernel matches the scalar one.
+    std::vector<float> in = generate_test_vector<float>(0, 1000, 1000);
+    std::vector<float> out(in.size());
+    mitchell_log(in.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); i++) {
+        assert(out[i] == mitchell_log(in[i]));
+    }
 }
 
 int main(int argc, char **argv) {
@@ -128,9 +140,23 @@ int main(int argc, char **argv) {
     std::vector<double> iv = generate_test_vector(0.5, 10., 10000);
     validate_error(iv);
     validate_monotonic();
+    validate_mitchell_error();
 
-    bench("fast_log", fastlog2, iv);
+    bench("fast_log", fastlog2<>, iv);
     bench("libm_log", log, iv);
     bench("nop     ", nop, iv);
+
+    // The monotone tier, against the float kernels.
+    std::vector<float> fv(iv.begin(), iv.end());
+    bench_throughput("mitchell_log_throughput     ", mitchell_log, fv);
+    bench_throughput("my_log_throughput           ", my_log, fv);
+
+    // The latency and the throughput of the polynomial schemes.
+    bench_latency("fast_log_horner_latency    ", fastlog2<PolyScheme::Horner>, iv);
+    bench_latency("fast_log_estrin_latency    ", fastlog2<PolyScheme::Estrin>, iv);
+    bench_latency("fast_log_even_odd_latency  ", fastlog2<PolyScheme::EvenOdd>, iv);
+    bench_throughput("fast_log_horner_throughput  ", fastlog2<PolyScheme::Horner>, iv);
+    bench_throughput("fast_log_estrin_throughput  ", fastlog2<PolyScheme::Estrin>, iv);
+    bench_throughput("fast_log_even_odd_throughput", fastlog2<PolyScheme::EvenOdd>, iv);
     return 0;
 }
@@ -0,0 +1,128 @@
+#ifndef LOG_APPROX_H
+#define LOG_APPROX_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "poly.h"
+#include "util.h"
+
+/// @returns the exponent and a normalized mantissa with the relationship:
+/// [a * 2^b] = x
+inline std::pair<double, int> my_frexp(double x) {
+    uint64_t bits = bit_cast<uint64_t, double>(x);
+    if (bits == 0) {
+        return { 0., 0 };
+    }
+    // See:
+    // https://en.wikipedia.org/wiki/IEEE_754#Basic_and_interchange_formats
+
+    // Extract the 52-bit mantissa field.
+    uint64_t mantissa = bits & 0xFFFFFFFFFFFFF;
+    bits >>= 52;
+
+    // Extract the 11-bit exponent field, and add the bias.
+    int exponent = int(bits & 0x7ff) - 1023;
+    bits >>= 11;
+
+    // Extract the sign bit.
+    uint64_t sign = bits;
+    bits >>= 1;
+
+    // Construct the normalized double;
+    uint64_t res = sign;
+    res <<= 11;
+    res |= 1023 - 1;
+    res <<= 52;
+    res |= mantissa;
+
+    double frac = bit_cast<double, uint64_t>(res);
+    return { frac, exponent + 1 };
+}
+
+// The minimax polynomial of log2(x) in the range [0.5 .. 1], the range of the
+// mantissa of my_frexp, with an absolute error of 2^-10.6. Generated with:
+//   remez --metric abs --name fastlog2_coeffs log2 0.5 1 3
+inline constexpr double fastlog2_coeffs[4] = {
+    -0x1.93a9d7ebc700dp+1, 0x1.8621115673fe3p+2, -0x1.0d47ae71c1578p+2, 0x1.4417e552b254bp+0,
+};
+
+/// Approximate log(x) for a positive \p x, with a degree-3 polynomial of the
+/// log2 of the mantissa. This is the fast and inaccurate sibling of my_log.
+template <PolyScheme Scheme = PolyScheme::Horner> KERNEL_API double fastlog2(double x) {
+
+    /// Extract the fraction, and the power-of-two exponent.
+
+    auto a = my_frexp(x);
+    x = a.first;
+    int pow2 = a.second;
+
+    // Use a 4-part polynom to approximate log2(x);
+    double log2 = 0.6931471805599453;
+    double val = poly<Scheme>(x, fastlog2_coeffs);
+
+    // Compute log2(x), and convert the result to base-e.
+    return log2 * (pow2 + val);
+}
+
+// The correction of the Mitchell approximation, log2(1 + m) - m, at the 65
+// points m = i / 64, in units of 2^-16. The entries are shifted up by half of
+// the largest error of the linear interpolation, which centers the error.
+// Generated with print_mitchell_table().
+inline constexpr int32_t mitchell_table[65] = {
+    1, 443, 863, 1261, 1637, 1994, 2330, 2647, 2946, 3226, 3488, 3733, 3962,
+    4174, 4370, 4550, 4715, 4866, 5002, 5124, 5232, 5327, 5409, 5478, 5535, 5579,
+    5612, 5632, 5642, 5640, 5627, 5603, 5570, 5525, 5471, 5407, 5333, 5250, 5157,
+    5056, 4945, 4826, 4698, 4562, 4418, 4265, 4105, 3936, 3760, 3577, 3386, 3187,
+    2982, 2770, 2550, 2324, 2091, 1852, 1606, 1354, 1096, 831, 560, 284, 1,
+};
+
+/// Approximate log(x) for a non-negative \p x, in a few integer instructions.
+///
+/// This is the Mitchell approximation: the bits of a positive float, read as
+/// an integer, are 2^23 * (E + 127 + m) for x = 2^E * (1 + m), which is a
+/// piecewise linear approximation of log2(x). The correction log2(1 + m) - m
+/// is interpolated from mitchell_table, in integers, on the top 16 bits of
+/// the mantissa.
+///
+/// The result is monotone non-decreasing over all the non-negative floats,
+/// from +0 through the denormals to +inf, which log_approx.cc proves
+/// exhaustively. Each step of the key adds one unit to the approximation,
+/// and the interpolated correction drops by at most one unit per step,
+/// because its slope is above -0.28, so the integer never decreases. It
+/// converts exactly to float, and the scaling rounds monotonically. The
+/// absolute error is below 5e-5 for the normal floats. -0 is +0, and the
+/// negative inputs and NaN return NaN.
+///
+/// It is not strictly increasing. The key is bits >> 7, so the result is a
+/// staircase: it is constant on each run of 128 consecutive floats, and it
+/// ties across adjacent keys wherever the correction drops by one unit (1.4M
+/// of the 16.7M keys). Don't use it where distinct inputs need distinct
+/// results. The ends are not log(x) either: the denormals read as 2^-127
+/// times 1 + m, so mitchell_log(+0) = mitchell_log(0x1p-149f) = -88.03 and
+/// the denormals are in [-88.03 .. -87.34), and mitchell_log(+inf) = 88.72
+/// like the largest float.
+KERNEL_API float mitchell_log(float x) {
+    uint32_t bits = bit_cast<uint32_t, float>(x) & 0x7fffffff;
+    // The exponent and the top 16 bits of the mantissa, in units of 2^-16.
+    int32_t key = int32_t(bits >> 7);
+    size_t segment = (key >> 10) & 63;
+    int32_t frac = key & 1023;
+    int32_t lo = mitchell_table[segment];
+    int32_t hi = mitchell_table[segment + 1];
+    int32_t log2_x = key - (127 << 16) + lo + (((hi - lo) * frac) >> 10);
+    // log(2) / 2^16.
+    float r = float(log2_x) * 0x1.62e43p-17f;
+    return blend(-uint32_t(!(x >= 0)), NAN, r);
+}
+
+/// Compute \p out[i] = mitchell_log(\p in[i]) for \p n elements.
+KERNEL_API void mitchell_log(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = mitchell_log(in[i]);
+    }
+}
+
+#endif // LOG_APPROX_H
@@ -0,0 +1,125 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <math.h>
+#include <quadmath.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "log_dd.h"
+#include "util.h"
+
+// Prints the lookup table of {hi, lo}, where hi + lo = log(r) for the
+// reciprocals r of masked_recp_table.
+void print_dd_log_recp_table() {
+    printf("inline constexpr uint64_t dd_log_recp_table[256 * 2] = {");
+    for (int i = 0; i < 256; i++) {
+        __float128 lnr = logq(__float128(bit_cast<double, uint64_t>(masked_recp_table[i])));
+        double hi = double(lnr);
+        double lo = double(lnr - hi);
+        if (i % 2 == 0) {
+            printf("\n   ");
+        }
+        printf(" 0x%016lx, 0x%016lx,", bit_cast<uint64_t, double>(hi), bit_cast<uint64_t, double>(lo));
+    }
+    printf("\n};\n");
+}
+
+/// @return the relative error of \p r compared to log(x) in __float128.
+double relative_error(double x, DoubleDouble r) {
+    __float128 ref = logq(__float128(x));
+    __float128 err = (__float128(r.hi) + __float128(r.lo)) - ref;
+    return ref == 0 ? 0 : double(fabsq(err / ref));
+}
+
+void check() {
+    assert(my_log_dd(1.).hi == 0 && my_log_dd(1.).lo == 0);
+    assert(my_log_dd(0.).hi == -INFINITY && my_log_dd(-0.).hi == -INFINITY);
+    assert(my_log_dd(INFINITY).hi == INFINITY);
+    assert(std::isnan(my_log_dd(-1.).hi) && std::isnan(my_log_dd(NAN).hi));
+
+    // The extremes, and the values around one, where the result cancels.
+    for (double x : { 0x1p-1074, 0x1.8p-1070, 0x1p-1022, 0x1.fffffffffffffp1023, 1 + 0x1p-52,
+                      1 - 0x1p-53, 1 + 0x1p-8, 1 - 0x1p-8, 0.5, 2., 10. }) {
+        assert(relative_error(x, my_log_dd(x)) < 0x1p-100);
+    }
+
+    // The batch kernel matches the scalar one, including the special values.
+    std::vector<double> in = generate_test_vector<double>(0, 100, 1000);
+    for (double x : { 0., -1., 0x1p-1070, double(INFINITY), double(NAN), 1 - 0x1p-9 }) {
+        in.push_back(x);
+    }
+    std::vector<double> hi(in.size()), lo(in.size());
+    my_log_dd(in.data(), hi.data(), lo.data(), in.size());
+    for (size_t i = 0; i < in.size(); i++) {
+        DoubleDouble r = my_log_dd(in[i]);
+        assert(memcmp(&hi[i], &r.hi, sizeof(double)) == 0);
+        assert(memcmp(&lo[i], &r.lo, sizeof(double)) == 0);
+    }
+}
+
+/// Compare my_log_dd to __float128 on \p n random inputs: all the positive
+/// doubles, and the values near one.
+void print_errors(int n) {
+    std::mt19937_64 mt(42);
+    double max_err = 0;
+    Histogram<4> hist;
+    for (int i = 0; i < n; i++) {
+        double x;
+        if (i % 2) {
+            x = bit_cast<double, uint64_t>(mt() % 0x7ff0000000000000);
+        } else {
+            x = 1 + std::ldexp(double(int64_t(mt())), -70);
+        }
+        DoubleDouble r = my_log_dd(x);
+        max_err = std::max(max_err, relative_error(x, r));
+        hist.add(ulp_difference<uint64_t, double>(r.hi, double(logq(__float128(x)))));
+    }
+    printf("Max relative error = 2^%.2f\n", std::log2(max_err));
+    hist.dump("\nULP delta (my_log_double):\n", n);
+}
+
+double libm_log(double x) { return log(x); }
+double libm_logl(double x) { return double(logl((long double)x)); }
+double libm_logq(double x) { return double(logq(__float128(x))); }
+
+// The batch of the scalar kernel, one call per element.
+void __attribute__((noinline)) scalar_log_dd(const double *in, double *hi, double *lo, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        DoubleDouble r = my_log_dd(in[i]);
+        hi[i] = r.hi;
+        lo[i] = r.lo;
+    }
+}
+
+// The batch of long double, which has 64 bits of precision.
+void __attribute__((noinline)) batch_logl(const double *in, double *hi, double *lo, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        long double r = logl((long double)in[i]);
+        hi[i] = double(r);
+        lo[i] = double(r - hi[i]);
+    }
+}
+
+int main(int argc, char **argv) {
+    // Print the table of log_dd.h.
+    if (argc == 2 && std::string(argv[1]) == "--print-table") {
+        print_dd_log_recp_table();
+        return 0;
+    }
+    check();
+    print_errors(1000000);
+
+    std::vector<double> iv = generate_test_vector<double>(0.01, 1000., 10000);
+    // Fewer iterations than the other benchmarks, because of __float128.
+    bench_throughput("my_log_double", my_log_double, iv, 1000);
+    bench_throughput("libm_log     ", libm_log, iv, 1000);
+    bench_throughput("libm_logl    ", libm_logl, iv, 1000);
+    bench_throughput("libm_logq    ", libm_logq, iv, 1000);
+    bench_batch("batch_my_log_dd    ", my_log_dd, iv, 1000);
+    bench_batch("batch_scalar_log_dd", scalar_log_dd, iv, 1000);
+    bench_batch("batch_logl         ", batch_logl, iv, 1000);
+    return 0;
+}
@@ -0,0 +1,262 @@
+#ifndef LOG_DD_H
+#define LOG_DD_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "double_double.h"
+#include "log_accurate.h"
+#include "poly.h"
+#include "util.h"
+
+// A lookup table of pairs {hi, lo}, where hi + lo = log(r) for the entries r
+// of masked_recp_table, with 106 bits. Generated with print_dd_log_recp_table().
+inline constexpr uint64_t dd_log_recp_table[256 * 2] = {
+    0x3fe62e42fefa39ef, 0x3c7abc9e3b39803f, 0x3fe5ee82aa241920, 0x3c3c066d235ee630,
+    0x3fe5af405c3649e0, 0x3c731d60864fd949, 0x3fe5707a26bb8c66, 0x3c48bff3303dd480,
+    0x3fe5322e26867857, 0x3c8cc45d257530a6, 0x3fe4f45a835a4e19, 0xbc8145b64ee3eac5,
+    0x3fe4b6fd6f970c1f, 0x3c81457b531506f6, 0x3fe47a1527e8a2d4, 0xbc87abe53582a7bc,
+    0x3fe43d9ff2f923c5, 0xbc8427a40828fb8d, 0x3fe4019c2125ca93, 0xbc79c987863a5cf3,
+    0x3fe3c6080c36bfb5, 0x3c7f930603d87b6e, 0x3fe38ae2171976e8, 0xbc7fd5daab4d22ba,
+    0x3fe35028ad9d8c85, 0x3c8e7f2a4fcd5752, 0x3fe315da4434068b, 0xbc709e2d076cde9c,
+    0x3fe2dbf557b0df43, 0xbc3941ee770436b3, 0x3fe2a2786d0ec107, 0xbc77a0c343be95dc,
+    0x3fe269621134db92, 0xbc4f10522624fd5a, 0x3fe230b0d8bebc98, 0xbc7fe646de6612e6,
+    0x3fe1f8635fc61658, 0x3c86f4d805f8b3f4, 0x3fe1c07849ae6007, 0xbc75642251e3331e,
+    0x3fe188ee40f23ca7, 0xbc6d883aa5cd7d41, 0x3fe151c3f6f29612, 0xbc56f45275c917a3,
+    0x3fe11af823c75aa8, 0x3c77c223111a707b, 0x3fe0e4898611cce1, 0x3c82b00f002e836e,
+    0x3fe0ae76e2d054fa, 0xbc7e51de060763e6, 0x3fe078bf0533c568, 0x3c860907b7d7f47e,
+    0x3fe04360be7603ae, 0xbc8e5fe79539e041, 0x3fe00e5ae5b207ab, 0x3c5ee2746c271c31,
+    0x3fdfb358af7a4884, 0xbc7c0b87d36d96d4, 0x3fdf4aa7ee03192e, 0xbc6cd487f5aba5e6,
+    0x3fdee2a156b413e5, 0xbc725d2dc7ed7960, 0x3fde7b42c3ddad74, 0x3c737d646a17bc69,
+    0x3fde148a1a2726cf, 0xbc7ac81cc8a4dfb9, 0x3fddae75484c9615, 0xbc7eb5837185a662,
+    0x3fdd490246defa6a, 0x3c7d7f4d3b3d406b, 0x3fdce42f18064744, 0xbc74867d8f4d60c7,
+    0x3fdc7ff9c74554ca, 0xbc6ddc15249ae4b7, 0x3fdc1c60693fa39e, 0xbc7cfc00b8f3feaa,
+    0x3fdbb9611b80e2fc, 0xbc3205faccc9bc45, 0x3fdb56fa0446290a, 0x3c7a94b610665377,
+    0x3fdaf5295248cdcf, 0x3c79d56c45dd3e86, 0x3fda93ed3c8ad9e3, 0x3c295f53bd2e406c,
+    0x3fda33440224fa79, 0xbc7dd40314305712, 0x3fd9d32bea15ed3a, 0x3c487bcbcfd3e183,
+    0x3fd973a3431356ae, 0xbc7c4e940b67c1c8, 0x3fd914a8635bf689, 0xbc73d4bb98c1f2c5,
+    0x3fd8b639a88b2df4, 0x3c78f0d0c7dc7cfd, 0x3fd85855776dcbfb, 0xbc7586666443b153,
+    0x3fd7fafa3bd8151c, 0x3c7b79bf6d4cb122, 0x3fd79e26687cfb3d, 0x3c7fe977e8bbc0de,
+    0x3fd741d876c67bb1, 0xbc5ed6c473e9a9f5, 0x3fd6e60ee6af1973, 0xbc756a0f7749e5cd,
+    0x3fd68ac83e9c6a15, 0xbc6acd8a9145ff44, 0x3fd630030b3aac48, 0x3c7ee0c6728fffcc,
+    0x3fd5d5bddf595f31, 0x3c4d5f75b9a23ae4, 0x3fd57bf753c8d1fb, 0xbc62908d15f88b63,
+    0x3fd522ae0738a3d7, 0x3c73840b263acb43, 0x3fd4c9e09e172c3d, 0xbc5123615b147a5f,
+    0x3fd4718dc271c41c, 0x3c7d8fb4c14c56ee, 0x3fd419b423d5e8c6, 0x3c55b7648704e721,
+    0x3fd3c25277333183, 0x3c7152d81af5713a, 0x3fd36b6776be1116, 0xbc5324f0e8838590,
+    0x3fd314f1e1d35ce3, 0x3c722966f61a3c23, 0x3fd2bef07cdc9355, 0xbc722dad7fd86088,
+    0x3fd269621134db91, 0x3c7e0efadd9db02a, 0x3fd214456d0eb8d5, 0xbc550a2dca28b3ed,
+    0x3fd1bf99635a6b95, 0xbc7e9575c2124912, 0x3fd16b5ccbacfb73, 0x3c756fbd28b40935,
+    0x3fd1178e8227e47a, 0x3c7b8ce2d07f1cb7, 0x3fd0c42d676162e2, 0xbc75a74e18a8bb85,
+    0x3fd07138604d5864, 0xbc324e912b16ec8b, 0x3fd01eae5626c691, 0x3c6d9f5bd0b5b348,
+    0x3fcf991c6cb3b37a, 0x3c5ecca0cdf30143, 0x3fcef5ade4dcffe5, 0x3c57754d2238f75f,
+    0x3fce530effe71013, 0xbc6f7627ef82f3f0, 0x3fcdb13db0d48941, 0xbc68af715b0349a4,
+    0x3fcd1037f2655e7b, 0xbc53f3adb7b71cbc, 0x3fcc6ffbc6f00f71, 0xbc6ae58b2c57a4a5,
+    0x3fcbd087383bd8aa, 0xbc41165504ad749e, 0x3fcb31d8575bce3b, 0xbc40d4eace1aa537,
+    0x3fca93ed3c8ad9e5, 0x3c6bcafa9de97202, 0x3fc9f6c407089663, 0xbc652979a7e86605,
+    0x3fc95a5adcf70182, 0x3c68a16283fdbd1c, 0x3fc8beafeb38fe8f, 0xbc454aae92cd0b87,
+    0x3fc823c16551a3c0, 0x3c66dcd318f4187e, 0x3fc7898d85444c74, 0x3c3be3dbaf3ec804,
+    0x3fc6f0128b756ab9, 0xbc437967087859b9, 0x3fc6574ebe8c1339, 0x3c6c5961e173bc82,
+    0x3fc5bf406b543db0, 0xbc21f5b44c0df7f7, 0x3fc527e5e4a1b58d, 0xbc3b8d4b411cadff,
+    0x3fc4913d8333b563, 0xbc50d5604930f137, 0x3fc3fb45a59928ca, 0xbc6d87e6a354d057,
+    0x3fc365fcb0159014, 0x3c6bea08d2dca256, 0x3fc2d1610c86813d, 0x3c3d997036941a6d,
+    0x3fc23d712a49c201, 0x3c651c7e9efae297, 0x3fc1aa2b7e23f729, 0x3c66e44389934420,
+    0x3fc1178e8227e47a, 0xbc50e63a5f01c693, 0x3fc08598b59e3a07, 0xbc6fd7009902bf32,
+    0x3fbfe89139dbd565, 0xbc5ac9f4215f9394, 0x3fbec739830a1126, 0x3c5eea033743f95b,
+    0x3fbda7276384469e, 0x3c5401fa71733017, 0x3fbc885801bc4b20, 0xbc55c734aa6598fc,
+    0x3fbb6ac88dad5b1d, 0xbc5002bf768e52d0, 0x3fba4e7640b1bc38, 0xbc59b5ca203e4259,
+    0x3fb9335e5d594988, 0xbc5478a85704ccb7, 0x3fb8197e2f40e3f0, 0xbc4230690020895f,
+    0x3fb700d30aeac0e8, 0x3c4a36a677b4c8b2, 0x3fb5e95a4d9791cd, 0xbc54c78ba3a3baf6,
+    0x3fb4d3115d207eac, 0x3c3da7d0b1e10b2f, 0x3fb3bdf5a7d1ee5e, 0x3c3f52eda76b68ac,
+    0x3fb2aa04a44717a1, 0x3c5aea2c72d05c08, 0x3fb1973bd1465561, 0xbc57aac1b3d35680,
+    0x3fb08598b59e3a06, 0xbc5dd7009902bf32, 0x3faeea31c006b87c, 0xbc37c9f9276f6cd8,
+    0x3faccb73cdddb2d0, 0xbc4e48fb0500efd5, 0x3faaaef2d0fb1108, 0x3c468d4eed0b82ae,
+    0x3fa894aa149fb34b, 0xbc42ba0b44cfaee5, 0x3fa67c94f2d4bb65, 0x3c40413e6505e5f9,
+    0x3fa466aed42de3f9, 0xbc39badefe942718, 0x3fa252f32f8d1840, 0x3c2ae021b67a9ba8,
+    0x3fa0415d89e74440, 0x3c4c05cf1d753621, 0x3f9c63d2ec14aad7, 0x3c08fe7acbca131d,
+    0x3f98492528c8cac5, 0xbc3d192d0619fa68, 0x3f9432a925980cbc, 0xbc38cdaf39004193,
+    0x3f90205658935837, 0x3c327c8e8416e717, 0x3f882448a388a283, 0x3c104b16137f0970,
+    0x3f8010157588de69, 0x3c146662d417cece, 0x3f70080559588b25, 0x3c1f96638cf63675,
+    0x0000000000000000, 0x0000000000000000, 0xbf7fe02a6b106799, 0x3bce44b7e3711e7e,
+    0xbf8fc0a8b0fc03c4, 0x3c183092c5964281, 0xbf97b91b07d5b126, 0x3c16d80ab38e9430,
+    0xbf9f829b0e7832f8, 0xbc333e3f04f1ef25, 0xbfa39e87b9febd68, 0x3c45bfa937f551b7,
+    0xbfa77458f632dcff, 0xbc08d3ca87b92968, 0xbfab42dd711971b9, 0xbc40a34531f67db5,
+    0xbfaf0a30c01162a8, 0xbc485f325c5bbacd, 0xbfb16536eea37ae3, 0xbc52189705cf74ca,
+    0xbfb341d7961bd1d0, 0x3c53599f227becbb, 0xbfb51b073f06183c, 0x3c55b61c65e5741a,
+    0xbfb6f0d28ae56b4e, 0x3c420db323097324, 0xbfb8c345d6319b23, 0x3c5294d2f5668495,
+    0xbfba926d3a4ad562, 0x3c4d7a16eab1e2ad, 0xbfbc5e548f5bc743, 0xbc42eb0bf7c0b0d9,
+    0xbfbe27076e2af2ea, 0x3c361578001e015a, 0xbfbfec9131dbeabc, 0x3c55746b9981b36c,
+    0xbfc0d77e7cd08e5b, 0xbc69a5dc5e9030ad, 0xbfc1b72ad52f67a2, 0x3c6fbe7ee5c69946,
+    0xbfc29552f81ff521, 0xbc6301771c407dc0, 0xbfc371fc201e8f75, 0xbc1e6cb62af18a02,
+    0xbfc44d2b6ccb7d1c, 0xbc47d3d950f87e23, 0xbfc526e5e3a1b438, 0x3c6546ff8a470d3a,
+    0xbfc5ff3070a793d6, 0x3c5bc60efafc6f6c, 0xbfc6d60fe719d21b, 0xbc6d551d97132e87,
+    0xbfc7ab890210d907, 0x3c61072534a57e7d, 0xbfc87fa06520c911, 0x3c69f7fdbfa08d9a,
+    0xbfc9525a9cf456b6, 0x3c626fb3e2b1d1da, 0xbfca23bc1fe2b561, 0xbc624dc46c1ea664,
+    0xbfcaf3c94e80bff3, 0xbc6a3398064df33e, 0xbfcbc286742d8cd4, 0xbc5cfce744870f57,
+    0xbfcc8ff7c79a9a20, 0x3c64f689f8434011, 0xbfcd5c216b4fbb94, 0x3c5a37794d03657d,
+    0xbfce27076e2af2e8, 0x3c461578001e015e, 0xbfcef0adcbdc5935, 0xbc6e8637950dc20d,
+    0xbfcfb9186d5e3e29, 0xbc6355519b0de535, 0xbfd0402594b4d041, 0x3c608ec217a5022d,
+    0xbfd0a324e27390e2, 0xbc7bdcfde8061c04, 0xbfd1058bf9ae4ad4, 0xbc03f415699663ec,
+    0xbfd1675cababa60f, 0xbc2ce63eab883727, 0xbfd1c898c16999fb, 0xbc79f1a39d500e3c,
+    0xbfd22941fbcf7966, 0x3c5dbd7ac258a2bd, 0xbfd2895a13de86a4, 0xbc77ad24c13f040f,
+    0xbfd2e8e2bae11d31, 0x3c61e99b72bd7bf2, 0xbfd347dd9a987d56, 0x3c716ea62c048cfb,
+    0xbfd3a64c556945ea, 0xbc3cbcd735d03424, 0xbfd404308686a7e4, 0x3c6f79f6c1059cdb,
+    0xbfd4618bc21c5ec2, 0x3c27a42642661c62, 0xbfd4be5f957778a1, 0x3c54b366b609027a,
+    0xbfd51aad872df82e, 0x3c7d8db0a7cc1544, 0xbfd5767717455a6c, 0x3c6fb2a49af933e8,
+    0xbfd5d1bdbf5809ca, 0x3c77dc9c7c23801f, 0xbfd62c82f2b9c796, 0x3c5090a0dd59fe35,
+    0xbfd686c81e9b14ad, 0xbc7710af840538e3, 0xbfd6e08eaa2ba1e4, 0x3c7bfb1b39ca3a0f,
+    0xbfd739d7f6bbd007, 0xbc5ce24c53fad3f0, 0xbfd792a55fdd47a1, 0xbc7f057691fe9ed7,
+    0xbfd7eaf83b82afc2, 0x3c4698b43096b576, 0xbfd842d1da1e8b18, 0xbc754ec519784677,
+    0xbfd89a3386c1425b, 0xbc62d38c40881e0b, 0xbfd8f11e873662c8, 0xbc7f85da755a61a3,
+    0xbfd947941c2116fb, 0xbc61266e8a3e8838, 0xbfd99d958117e08a, 0x3c7315b444ee1f38,
+    0xbfd9f323ecbf984d, 0x3c4a92e513217f58, 0xbfda484090e5bb09, 0xbc7fff29adc3ad3b,
+    0xbfda9cec9a9a084a, 0x3c5ab7b00ad0dabc, 0xbfdaf1293247786b, 0xbc5533844a15dc28,
+    0xbfdb44f77bcc8f64, 0x3c2a0892a8b38eed, 0xbfdb9858969310fd, 0x3c6f3827583b8877,
+    0xbfdbeb4d9da71b7a, 0xbc7be1874deaef08, 0xbfdc3dd7a7cdad4d, 0xbc67d9e0a5bd4d37,
+    0xbfdc8ff7c79a9a21, 0xbc73097607bcbfee, 0xbfdce1af0b85f3ec, 0x3c66416a1aa97b31,
+    0xbfdd32fe7e00ebd5, 0xbc64ef6465f5f46e, 0xbfdd83e7258a2f3e, 0xbc5c515ba2ec9444,
+    0xbfddd46a04c1c4a1, 0x3c119d95b62e2476, 0xbfde24881a7c6c26, 0xbc605ec7a2caa523,
+    0xbfde744261d68789, 0xbc7cdf68dbcf2ed3, 0xbfdec399d2468cc1, 0x3c494623581958cf,
+    0xbfdf128f5faf06ec, 0x3c7328df13bb38c2, 0xbfdf6123fa7028ad, 0xbc55456c3cb6cd06,
+    0xbfdfaf588f78f31d, 0xbc6cd7d9f2754362, 0xbfdffd2e0857f497, 0x3c44d05f9366f27f,
+    0xbfe02552a5a5d0ff, 0xbc6e9c695d7ee800, 0xbfe04bdf9da926d2, 0xbc78fe60804593bf,
+    0xbfe0723e5c1cdf41, 0x3c46a1a71dbba44e, 0xbfe0986f4f573521, 0x3c737012b5805e02,
+    0xbfe0be72e4252a83, 0xbc7b4c4bdd99efff, 0xbfe0e44985d1cc8c, 0x3c4c546885a5a707,
+    0xbfe109f39e2d4c96, 0xbc8f78fb26c2de46, 0xbfe12f719593efbd, 0x3c767f6e731c1795,
+    0xbfe154c3d2f4d5ea, 0xbc698f33a3965e29, 0xbfe179eabbd899a0, 0x3c5c73e320bf059f,
+    0xbfe19ee6b467c96f, 0x3c6fa3422887e218, 0xbfe1c3b81f713c25, 0x3c70b583899021d1,
+    0xbfe1e85f5e7040d1, 0x3c8084e99683070e, 0xbfe20cdcd192ab6e, 0x3c8aabf0bc229014,
+    0xbfe23130d7bebf43, 0x3c8748725e374d6e, 0xbfe2555bce98f7ca, 0xbc89810eb6b440f4,
+    0xbfe2795e1289b11b, 0xbc8ade0fcf6e5a1d, 0xbfe29d37fec2b08b, 0xbc801735b2e9733f,
+    0xbfe2c0e9ed448e8c, 0x3c88a158f3917586, 0xbfe2e47436e40268, 0xbc80950861a4886b,
+    0xbfe307d7334f10be, 0xbc7fdac850fab36d, 0xbfe32b1339121d71, 0xbc7d02ab5b3d916b,
+    0xbfe34e289d9ce1d2, 0xbc7775c96c42e729, 0xbfe37117b54747b6, 0x3c8808bf6deec882,
+    0xbfe393e0d3562a1a, 0x3c838eef67f2483a, 0xbfe3b68449fffc23, 0xbc8c63b7b06164da,
+    0xbfe3d9026a7156fb, 0xbc50084c7a15a4f5, 0xbfe3fb5b84d16f43, 0xbc70a74ea82e55df,
+    0xbfe41d8fe84672af, 0x3c8ee6d0cf42e7fa, 0xbfe43f9fe2f9ce67, 0xbc8e1c9ee6d83b86,
+    0xbfe4618bc21c5ec2, 0xbc7e85bd9bd99e3a, 0xbfe48353d1ea88df, 0x3c840a85d133f80b,
+    0xbfe4a4f85db03ebb, 0x3c8d76102e1644f2, 0xbfe4c679afccee39, 0x3c6e971322ce7900,
+    0xbfe4e7d811b75bb0, 0x3c85d3d9ea6e9ea8, 0xbfe50913cc01686b, 0xbc79e59d2d85ab62,
+    0xbfe52a2d265bc5ab, 0xbc773be4578ad97b, 0xbfe54b2467999498, 0xbc8f4550a2d0f60c,
+    0xbfe56bf9d5b3f399, 0xbc611c6217363fcb, 0xbfe58cadb5cd7989, 0xbc8624bc9764c22c,
+    0xbfe5ad404c359f2d, 0xbc8eca6aa97c08e7, 0xbfe5cdb1dc6c1765, 0xbc747b71e2eb8419,
+    0xbfe5ee02a9241676, 0x3c8bca7da80b6f7e, 0xbfe60e32f44788d9, 0x3c658376a5f4b135,
+};
+
+/// Compute log(x * 2^E) for a positive normal double \p x, as the
+/// double-double value hi + lo, with a relative error below 2^-100.
+///
+/// This is the reduction of my_log with a double-double result: x = 2^E * m,
+/// with m in [sqrt(2)/2 .. sqrt(2)], and r is the reciprocal of the table
+/// point below m. Then log(x) = E*log(2) - log(r) + log1p(z), with z = m*r - 1
+/// below 2^-7. The product m*r is computed exactly, log(r) and log(2) are
+/// double-double constants, and log1p(z) is the Taylor polynomial of degree
+/// 14. The terms of degree 8 and above are below 2^-49 * z, so they are
+/// evaluated in double, and the rest with double-double Horner steps. There
+/// are no branches, so the batch loop vectorizes.
+inline __attribute__((always_inline)) DoubleDouble log_dd_normal(double x, int E) {
+    uint64_t bits = bit_cast<uint64_t, double>(x);
+    uint64_t mantissa = bits & 0xFFFFFFFFFFFFF;
+    E += int(bits >> 52) - 1023;
+
+    // Reduce the range of m to [sqrt(2)/2 -- sqrt(2)], without a branch.
+    uint64_t big = mantissa > 0x6A09E667F3BCD;
+    E += int(big);
+    double m = bit_cast<double, uint64_t>((mantissa | 0x3ff0000000000000) - (big << 52));
+
+    size_t idx = masked_index(m);
+    uint64_t rb = masked_recp_table[idx];
+    uint64_t ln_r_hi = dd_log_recp_table[2 * idx];
+    uint64_t ln_r_lo = dd_log_recp_table[2 * idx + 1];
+
+    // Below one, -log(r) and log1p(z) cancel when x is near one. Use r = 1
+    // there, where z = m - 1 is exact, and |z| is still below 2^-7. This is
+    // a bit blend, because GCC turns a select into a branch or a masked load.
+    uint64_t near_one = -uint64_t((E == 0) & (std::abs(m - 1) < 0x1p-7));
+    rb = (rb & ~near_one) | (0x3ff0000000000000 & near_one);
+    double r = bit_cast<double, uint64_t>(rb);
+    DoubleDouble ln_r = { bit_cast<double, uint64_t>(ln_r_hi & ~near_one),
+                          bit_cast<double, uint64_t>(ln_r_lo & ~near_one) };
+
+    // z = m*r - 1 exactly: m*r is in [0.5 .. 2], so p.hi - 1 is exact.
+    DoubleDouble p = two_prod(m, r);
+    DoubleDouble z = two_sum(p.hi - 1, p.lo);
+
+    // log1p(z) = log1p(z.hi) + z.lo / (1 + z.hi), where the error of the
+    // split is below z.lo^2 < 2^-106.
+    double zh = z.hi;
+    double ln_1z_lo = z.lo / (1 + zh);
+
+    // log1p(zh) = zh * (c1 + zh * (c2 + ... )), where ck = (-1)^(k+1)/k.
+    DoubleDouble s = { poly<PolyScheme::Estrin>(zh, -1. / 8, 1. / 9, -1. / 10, 1. / 11, -1. / 12,
+                                                1. / 13, -1. / 14),
+                       0 };
+    s = dd_mul_add(s, zh, { 0x1.2492492492492p-3, 0x1.2492492492492p-57 });
+    s = dd_mul_add(s, zh, { -0x1.5555555555555p-3, -0x1.5555555555555p-57 });
+    s = dd_mul_add(s, zh, { 0x1.999999999999ap-3, -0x1.999999999999ap-57 });
+    s = dd_mul_add(s, zh, { -0.25, 0 });
+    s = dd_mul_add(s, zh, { 0x1.5555555555555p-2, 0x1.5555555555555p-56 });
+    s = dd_mul_add(s, zh, { -0.5, 0 });
+    s = dd_mul_add(s, zh, { 1, 0 });
+    DoubleDouble ln_1z = dd_mul(s, zh);
+    ln_1z.lo += ln_1z_lo;
+
+    // E*log(2), where E*log2_hi is exact with two_prod.
+    DoubleDouble e_ln2 = two_prod(double(E), 0x1.62e42fefa39efp-1);
+    e_ln2.lo += double(E) * 0x1.abc9e3b39803fp-56;
+
+    // The terms cancel by at most a factor of 3: when E is not zero, |E*log(2)|
+    // is above 2*|log(r)|, and when E is zero and m is below 1 - 2^-7, the
+    // result is below -2^-7, and |log1p(z)| is below 2^-7.
+    DoubleDouble res = dd_add_sloppy(e_ln2, { -ln_r.hi, -ln_r.lo });
+    return dd_add_sloppy(res, ln_1z);
+}
+
+/// Compute log(x) for a double \p x, as the double-double value hi + lo.
+inline DoubleDouble log_dd_impl(double x) {
+    // Handle the special values and the denormals, with a single branch on
+    // the common path.
+    int E = 0;
+    if (!(x >= 0x1p-1022 && x <= 0x1.fffffffffffffp1023)) {
+        if (x == 0) {
+            return { -INFINITY, 0 };
+        } else if (x < 0 || std::isnan(x)) {
+            return { std::nan(""), 0 };
+        } else if (std::isinf(x)) {
+            return { x, 0 };
+        }
+        // Scale the denormals to the normal range.
+        x *= 0x1p54;
+        E = -54;
+    }
+    return log_dd_normal(x, E);
+}
+
+/// @return log(x) as the double-double value hi + lo.
+KERNEL_API DoubleDouble my_log_dd(double x) { return log_dd_impl(x); }
+
+/// @return log(x) rounded to double. The result is within 1 ULP, and it is
+/// the correctly rounded result unless log(x) is within 2^-47 ULP of the
+/// midpoint between two doubles.
+KERNEL_API double my_log_double(double x) { return log_dd_impl(x).hi; }
+
+/// Compute \p hi[i] + \p lo[i] = log(\p in[i]) for \p n elements.
+KERNEL_API void my_log_dd(const double *in, double *hi, double *lo, size_t n) {
+    // The first loop vectorizes, and the second one fixes the rare inputs
+    // that are not positive normal doubles.
+    for (size_t i = 0; i < n; i++) {
+        DoubleDouble r = log_dd_normal(in[i], 0);
+        hi[i] = r.hi;
+        lo[i] = r.lo;
+    }
+    for (size_t i = 0; i < n; i++) {
+        double x = in[i];
+        if (!(x >= 0x1p-1022 && x <= 0x1.fffffffffffffp1023)) {
+            DoubleDouble r = log_dd_impl(x);
+            hi[i] = r.hi;
+            lo[i] = r.lo;
+        }
+    }
+}
+
+#endif // LOG_DD_H
@@ -0,0 +1,82 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "log_accurate.h"
+#include "log_float.h"
+#include "util.h"
+
+float accurate_log(float x) { return log((double)x); }
+
+// Prints the lookup table of {r, hi, lo} for c = 1 + k/128, where r is 1/c
+// rounded to float, and hi + lo = -log(r).
+void print_log_float_table() {
+    printf("inline constexpr uint32_t log_float_table[91 * 3] = {");
+    for (int k = -37; k <= 53; k++) {
+        float r = float(1 / (1 + k / 128.));
+        double lnr = -log(double(r));
+        float hi = float(lnr);
+        float lo = float(lnr - hi);
+        if ((k + 37) % 2 == 0) {
+            printf("\n   ");
+        }
+        printf(" 0x%08x, 0x%08x, 0x%08x,", bit_cast<uint32_t, float>(r),
+               bit_cast<uint32_t, float>(hi), bit_cast<uint32_t, float>(lo));
+    }
+    printf("\n};\n");
+}
+
+void check() {
+    float inf = INFINITY;
+    assert(my_log_float(1) == 0);
+    assert(my_log_float(0) == -inf && my_log_float(-0.f) == -inf);
+    assert(my_log_float(inf) == inf);
+    assert(std::isnan(my_log_float(-1)) && std::isnan(my_log_float(-inf)));
+    assert(std::isnan(my_log_float(NAN)));
+    assert(my_log_float(0x1p-149f) == float(log(0x1p-149)));
+
+    // The batch kernel matches the scalar one.
+    std::vector<float> in = generate_test_vector<float>(0, 100, 1000);
+    std::vector<float> out(in.size());
+    my_log_float(in.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); i++) {
+        assert(out[i] == my_log_float(in[i]));
+    }
+}
+
+// The double pipeline: my_log, one call per element.
+void __attribute__((noinline)) my_log_double(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = my_log(in[i]);
+    }
+}
+
+// The double pipeline without the special values, which vectorizes with half
+// of the lanes of the float pipeline.
+void __attribute__((noinline)) log_positive_double(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = log_positive(in[i]);
+    }
+}
+
+int main(int argc, char **argv) {
+    // Print the table of log_float.h.
+    if (argc == 2 && std::string(argv[1]) == "--print-table") {
+        print_log_float_table();
+        return 0;
+    }
+    check();
+    print_ulp_deltas(my_log_float, accurate_log);
+
+    std::vector<float> iv = generate_test_vector<float>(0.01, 1000., 10000);
+    bench("my_log      ", my_log, iv);
+    bench("my_log_float", my_log_float, iv);
+    bench_batch("batch_my_log         ", my_log_double, iv);
+    bench_batch("batch_log_positive   ", log_positive_double, iv);
+    bench_batch("batch_my_log_float   ", my_log_float, iv);
+    return 0;
+}
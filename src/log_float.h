@@ -0,0 +1,128 @@
+#ifndef LOG_FLOAT_H
+#define LOG_FLOAT_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "poly.h"
+#include "util.h"
+
+// A lookup table of triplets {r, hi, lo} for the 91 points c = 1 + k/128 in
+// the range [sqrt(2)/2 .. sqrt(2)], where r is 1/c rounded to float, and
+// hi + lo is -log(r) as a double-float. Generated with print_log_float_table().
+inline constexpr uint32_t log_float_table[91 * 3] = {
+    0x3fb40b41, 0xbeaeadf0, 0x31b4d41b, 0x3fb21643, 0xbea91571, 0x3198eb85,
+    0x3fb02c0b, 0xbea38c6e, 0xb0b8e20e, 0x3fae4c41, 0xbe9e1293, 0x322ccce8,
+    0x3fac7692, 0xbe98a790, 0xb27d35cd, 0x3faaaaab, 0xbe934b12, 0x326cb247,
+    0x3fa8e83f, 0xbe8dfcca, 0xb1169ae3, 0x3fa72f05, 0xbe88bc73, 0xb2427e48,
+    0x3fa57eb5, 0xbe8389c3, 0x3032a79e, 0x3fa3d70a, 0xbe7cc8e2, 0x30d31324,
+    0x3fa237c3, 0xbe729877, 0x30863bfc, 0x3fa0a0a1, 0xbe6881c2, 0x304d50ce,
+    0x3f9f1166, 0xbe5e843a, 0xb1c3bd8b, 0x3f9d89d9, 0xbe549f6c, 0xb1c8ad9d,
+    0x3f9c09c1, 0xbe4ad2d9, 0xb1ef7016, 0x3f9a90e8, 0xbe411e0c, 0xb12a3478,
+    0x3f991f1a, 0xbe378092, 0xb16ead55, 0x3f97b426, 0xbe2dfa04, 0x3115784a,
+    0x3f964fda, 0xbe2489e9, 0xb16676a8, 0x3f94f209, 0xbe1b2fe3, 0xb1c15900,
+    0x3f939a86, 0xbe11eb8b, 0x305b1f04, 0x3f924925, 0xbe08bc77, 0xb089f916,
+    0x3f90fdbc, 0xbdff4489, 0xb11dbd56, 0x3f8fb824, 0xbded393c, 0xb06111a8,
+    0x3f8e7835, 0xbddb563e, 0xb11ad5ad, 0x3f8d3dcb, 0xbdc99af2, 0xb1559498,
+    0x3f8c08c1, 0xbdb8069f, 0x2f8a9fbc, 0x3f8ad8f3, 0xbda6988b, 0xb0a40fd6,
+    0x3f89ae41, 0xbd95502c, 0xae8e2e8c, 0x3f888889, 0xbd842ccd, 0x31261c66,
+    0x3f8767ab, 0xbd665b93, 0xb03bb64a, 0x3f864b8a, 0xbd44a542, 0x30b604da,
+    0x3f853408, 0xbd23356d, 0x30bd21c8, 0x3f842108, 0xbd020ae4, 0xb09e7440,
+    0x3f83126f, 0xbcc24943, 0x2fe6e6d1, 0x3f820821, 0xbc8102d2, 0x2fed9533,
+    0x3f810204, 0xbc0080a8, 0x2fa77219, 0x3f800000, 0x80000000, 0x00000000,
+    0x3f7e03f8, 0x3bff015b, 0x2f310679, 0x3f7c0fc1, 0x3c7e0545, 0xaff03fc2,
+    0x3f7a232d, 0x3cbdc8d6, 0x307d5b12, 0x3f783e10, 0x3cfc14c8, 0x30678338,
+    0x3f76603e, 0x3d1cf437, 0x2f7f5ec6, 0x3f74898d, 0x3d3ba2ce, 0xaf66916e,
+    0x3f72b9d6, 0x3d5a16f0, 0x3091971d, 0x3f70f0f1, 0x3d785185, 0x2d0b1538,
+    0x3f6f2eb7, 0x3d8b29b9, 0xb175c852, 0x3f6d7304, 0x3d9a0eba, 0x30c37a3c,
+    0x3f6bbdb3, 0x3da8d837, 0xb03e79ec, 0x3f6a0ea1, 0x3db78694, 0xb151a94b,
+    0x3f6865ac, 0x3dc61a33, 0xafe7325e, 0x3f66c2b4, 0x3dd4936c, 0x3124ad57,
+    0x3f652598, 0x3de2f2a6, 0xaf2438b8, 0x3f638e39, 0x3df1383a, 0x3162af2e,
+    0x3f61fc78, 0x3dff648a, 0x2fedf55e, 0x3f607038, 0x3e06bbf4, 0x31cd08e6,
+    0x3f5ee95c, 0x3e0db958, 0x3017b3d4, 0x3f5d67c9, 0x3e14aa96, 0x3103fea6,
+    0x3f5beb62, 0x3e1b8fe1, 0xb19e1709, 0x3f5a740e, 0x3e22695a, 0xb166905b,
+    0x3f5901b2, 0x3e29372f, 0x31343687, 0x3f579436, 0x3e2ff983, 0x2fa793d5,
+    0x3f562b81, 0x3e36b07e, 0x31e19d22, 0x3f54c77b, 0x3e3d5c48, 0x31021b21,
+    0x3f53680d, 0x3e43fd04, 0x31441923, 0x3f520d21, 0x3e4a92d4, 0x2ff456b8,
+    0x3f50b6a0, 0x3e511de0, 0xae6a54c8, 0x3f4f6475, 0x3e579e49, 0xb16fe800,
+    0x3f4e168a, 0x3e5e1436, 0xb069398a, 0x3f4ccccd, 0x3e647fbd, 0x31735345,
+    0x3f4b8728, 0x3e6ae10a, 0x30d3eee6, 0x3f4a4588, 0x3e71383b, 0xb06a868c,
+    0x3f4907da, 0x3e778570, 0xb088e9b0, 0x3f47ce0c, 0x3e7dc8c6, 0xb0a8706f,
+    0x3f46980c, 0x3e82012e, 0xb214b2fb, 0x3f4565c8, 0x3e851928, 0x3227390f,
+    0x3f443730, 0x3e882c5f, 0xb2651b52, 0x3f430c31, 0x3e8b3ae5, 0xb205459f,
+    0x3f41e4bc, 0x3e8e44c6, 0xb2496660, 0x3f40c0c1, 0x3e914a0f, 0x31d9ef2d,
+    0x3f3fa030, 0x3e944ad0, 0x323de86a, 0x3f3e82fa, 0x3e974716, 0xb08f7168,
+    0x3f3d6910, 0x3e9a3eee, 0xb256782a, 0x3f3c5264, 0x3e9d3263, 0xb1d2d743,
+    0x3f3b3ee7, 0x3ea02185, 0xb25f9582, 0x3f3a2e8c, 0x3ea30c5d, 0x310717b2,
+    0x3f392144, 0x3ea5f2fd, 0xb2488876, 0x3f381703, 0x3ea8d56c, 0xb17481f4,
+    0x3f370fbb, 0x3eabb3ba, 0xb213aa59, 0x3f360b61, 0x3eae8ded, 0x31ab013a,
+    0x3f3509e7, 0x3eb16416, 0x32139c7a,
+};
+
+/// Compute log(x) with float arithmetic only, so that the batch kernel packs
+/// 16 lanes in an AVX-512 register, or 8 in an AVX2 register, instead of the
+/// 8 or 4 lanes of the double pipeline of my_log.
+///
+/// The input is reduced to x = 2^E * m with m in [sqrt(2)/2 .. sqrt(2)], and m
+/// is rounded to the nearest table point 1 + k/128. Then
+///   log(x) = E*log(2) - log(r) + log1p(z), where z = m*r - 1.
+/// The table point of k = 0 has r = 1, so near x = 1 the reduction is exact,
+/// and elsewhere |log(x)| is larger than 2^-8, so there is no cancellation.
+/// log(2) and -log(r) are double-float values, and the sum of the large terms
+/// is computed exactly with Fast2Sum. The error is below 1 ULP.
+inline float log_float_impl(float x) {
+    // Scale the denormals to the normal range.
+    bool denormal = x < 0x1p-126f;
+    float xs = denormal ? x * 0x1p23f : x;
+    uint32_t bits = bit_cast<uint32_t, float>(xs);
+    uint32_t mantissa = bits & 0x7fffff;
+    int E = int((bits >> 23) & 0xff) - 127 - 23 * int(denormal);
+
+    // Reduce the range of m to [sqrt(2)/2 -- sqrt(2)], without a branch.
+    uint32_t big = mantissa > 0x3504f3;
+    E = E + int(big);
+    float m = bit_cast<float, uint32_t>((mantissa | 0x3f800000) - (big << 23));
+
+    // The subtraction is exact, and k is in the range [-37 .. 53].
+    int k = int(std::nearbyint((m - 1) * 128));
+    unsigned idx = (k + 37) * 3;
+    float r = bit_cast<float, uint32_t>(log_float_table[idx]);
+    float lnr_hi = bit_cast<float, uint32_t>(log_float_table[idx + 1]);
+    float lnr_lo = bit_cast<float, uint32_t>(log_float_table[idx + 2]);
+
+    // |z| is below 2^-8, so the relative error of log1p(z) = z - z^2/2 + z^3/3
+    // - z^4/4 is below 2^-34.
+    float z = std::fma(m, r, -1.f);
+    float ln_1z = std::fma(z * z, poly<PolyScheme::Horner>(z, -0.5f, 1.f / 3, -0.25f), z);
+
+    // E * log2_hi is exact, because log2_hi has 16 significant bits. It is
+    // larger than |log(r)| < 0.35, unless E is zero, so Fast2Sum is exact.
+    float Ef = float(E);
+    float a = Ef * 0x1.62e4p-1f;
+    float s = a + lnr_hi;
+    float err = lnr_hi - (s - a);
+    float lo = err + std::fma(Ef, 0x1.7f7d1cp-20f, lnr_lo);
+    float res = s + (ln_1z + lo);
+
+    // Handle the special values. Zero, Inf, NaN and the negative numbers all
+    // wrap to the top of the range in the mask below.
+    uint32_t xb = bit_cast<uint32_t, float>(x);
+    uint32_t special = xb; // +Inf and NaN return x.
+    special = (xb << 1) == 0 ? 0xff800000 : special; // log(+-0) = -Inf.
+    special = xb > 0x80000000 ? 0xffc00000 : special; // log(-x) = NaN.
+    uint32_t mask = -uint32_t(xb - 1 >= 0x7f7fffff);
+    uint32_t rb = bit_cast<uint32_t, float>(res);
+    return bit_cast<float, uint32_t>((rb & ~mask) | (special & mask));
+}
+
+KERNEL_API float my_log_float(float x) { return log_float_impl(x); }
+
+/// Compute \p out[i] = log(\p in[i]) for \p n elements.
+KERNEL_API void my_log_float(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = log_float_impl(in[i]);
+    }
+}
+
+#endif // LOG_FLOAT_H
@@ -0,0 +1,105 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "log_int.h"
+#include "util.h"
+
+// The Verifier scans all the 32-bit patterns, so pass the integers as the
+// bits of a float.
+float my_log_u32_bits(float x) { return my_log_u32(bit_cast<uint32_t, float>(x)); }
+float my_log2_u32_bits(float x) { return my_log2_u32(bit_cast<uint32_t, float>(x)); }
+
+// Use the standard log(double) as the ground truth. The conversion of uint32
+// to double is exact.
+float accurate_log_u32_bits(float x) { return log((double)bit_cast<uint32_t, float>(x)); }
+float accurate_log2_u32_bits(float x) { return log2((double)bit_cast<uint32_t, float>(x)); }
+
+// Convert to float, which is what the callers do today.
+float __attribute__((noinline)) float_log_u32(uint32_t v) { return my_log(float(v)); }
+float __attribute__((noinline)) libm_log_u32(uint32_t v) { return logf(float(v)); }
+
+/// Check the 64-bit kernels on random integers of all magnitudes, and on the
+/// neighborhood of the powers of two.
+void validate_u64() {
+    std::vector<float> shifts = generate_test_vector<float>(0., 64., 1000000);
+    std::vector<uint64_t> iv;
+    for (auto s : shifts) {
+        iv.push_back(uint64_t(exp2l(s)) | 1);
+    }
+    for (unsigned i = 0; i < 64; i++) {
+        iv.push_back((1ull << i) - 1);
+        iv.push_back(1ull << i);
+        iv.push_back((1ull << i) + 1);
+    }
+    iv.push_back(~0ull);
+
+    Histogram<4> hist;
+    for (auto v : iv) {
+        hist.add(ulp_difference<unsigned, float>(my_log_u64(v), float(logl(v))));
+        hist.add(ulp_difference<unsigned, float>(my_log2_u64(v), float(log2l(v))));
+    }
+    hist.dump("\nULP delta (uint64):\n", 2 * iv.size());
+}
+
+void check() {
+    assert(my_log_u32(0u) == -INFINITY);
+    assert(my_log2_u64(0ull) == -INFINITY);
+    assert(my_log_u32(1u) == 0);
+    for (unsigned i = 0; i < 64; i++) {
+        assert(my_log2_u64(1ull << i) == float(i));
+    }
+}
+
+template <class IntTy>
+void bench(const std::string &name, float (*handle)(IntTy), const std::vector<IntTy> &iv,
+           int iterations = 10000) {
+    auto t1 = high_resolution_clock::now();
+
+    float sum = 0;
+    for (int iter = 0; iter < iterations; iter++) {
+        for (auto elem : iv) {
+            sum += handle(elem);
+        }
+    }
+
+    auto t2 = high_resolution_clock::now();
+    auto ms_int = duration_cast<milliseconds>(t2 - t1);
+    std::cout << "name = " << name << ", ";
+    std::cout << "sum = " << sum << ", ";
+    std::cout << "time = " << ms_int.count() << "ms\n";
+}
+
+int main(int argc, char **argv) {
+    check();
+    // Check all the uint32 values.
+    print_ulp_deltas(my_log_u32_bits, accurate_log_u32_bits);
+    print_ulp_deltas(my_log2_u32_bits, accurate_log2_u32_bits);
+    validate_u64();
+
+    // Counts are mostly small.
+    std::vector<float> fv = generate_test_vector<float>(0., 20., 10000);
+    std::vector<uint32_t> iv;
+    for (auto elem : fv) {
+        iv.push_back(uint32_t(exp2f(elem)));
+    }
+    bench("my_log_u32  ", my_log_u32, iv);
+    bench("float_log_u32", float_log_u32, iv);
+    bench("libm_log_u32", libm_log_u32, iv);
+
+    std::vector<float> out(iv.size());
+    auto t1 = high_resolution_clock::now();
+    float sum = 0;
+    for (int iter = 0; iter < 10000; iter++) {
+        my_log_u32(iv.data(), out.data(), iv.size());
+        sum += out[iter % out.size()];
+    }
+    auto t2 = high_resolution_clock::now();
+    std::cout << "name = batch_log_u32, sum = " << sum << ", time = "
+              << duration_cast<milliseconds>(t2 - t1).count() << "ms\n";
+    return 0;
+}
@@ -0,0 +1,97 @@
+#ifndef LOG_INT_H
+#define LOG_INT_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "log_accurate.h"
+#include "util.h"
+
+/// @return the number of leading zeros of \p x, which must not be zero.
+inline unsigned count_leading_zeros(uint32_t x) { return __builtin_clz(x); }
+inline unsigned count_leading_zeros(uint64_t x) { return __builtin_clzll(x); }
+
+/// Compute log(v), or log2(v) if \p Base2 is set, for the unsigned integer
+/// \p v. Integers can't be NaN, negative or denormal, so the only special
+/// value is zero. The exponent comes from the count of leading zeros, and the
+/// index into the masked tables comes from the top bits of the mantissa.
+template <bool Base2, class IntTy> double log_int(IntTy v) {
+    constexpr unsigned Bits = sizeof(IntTy) * 8;
+    // Use v|1 to keep clz defined. Zero is selected at the end.
+    unsigned lz = count_leading_zeros(IntTy(v | 1));
+    int E = int(Bits - 1 - lz);
+
+    // Normalize v such that the leading one is the top bit. The remaining
+    // bits are the fraction of the mantissa m = 1.frac in [1 .. 2).
+    IntTy n = IntTy(v << lz);
+    IntTy frac = IntTy(n << 1);
+
+    // Reduce the range of m to [sqrt(2)/2 -- sqrt(2)]. The fraction of sqrt(2)
+    // is 0x6A09E667F3BCC908...
+    constexpr IntTy sqrt2_frac = IntTy(0x6A09E667F3BCC908ull >> (64 - Bits));
+    uint64_t big = frac > sqrt2_frac;
+    E = E + int(big);
+
+    // The table index is made of the lowest exponent bit of m, which is zero
+    // after the division by two, and the top 7 bits of the fraction.
+    unsigned idx = unsigned((1 - big) << 7) | unsigned(frac >> (Bits - 7));
+
+    // Convert the mantissa to double, and divide it by two with integer
+    // arithmetic on the exponent of the scale.
+    double scale = bit_cast<double, uint64_t>(0x3ff0000000000000 - (big << 52));
+    double m = double(n) * (scale / double(IntTy(1) << (Bits - 1)));
+
+    double ri = bit_cast<double, uint64_t>(masked_recp_table[idx]);
+    double ln_ri = bit_cast<double, uint64_t>(masked_log_recp_table[idx]);
+    double z = std::fma(m, ri, -1);
+    // The polynomial has no constant term, so the powers of two, where z = 0,
+    // and in particular log(1) = 0, are exact.
+    double ln_1z = approximate_log_pol_1_to_1001(z);
+    double ln_m = ln_1z - ln_ri;
+
+    double res;
+    if (Base2) {
+        // log2(e) = 1/log(2).
+        res = E + ln_m * 1.4426950408889634;
+    } else {
+        double log2 = bit_cast<double, uint64_t>(0x3fe62e42fefa39ef);
+        res = E * log2 + ln_m;
+    }
+    return v == 0 ? -INFINITY : res;
+}
+
+KERNEL_API float my_log_u32(uint32_t v) { return log_int<false>(v); }
+KERNEL_API float my_log2_u32(uint32_t v) { return log_int<true>(v); }
+KERNEL_API float my_log_u64(uint64_t v) { return log_int<false>(v); }
+KERNEL_API float my_log2_u64(uint64_t v) { return log_int<true>(v); }
+
+/// Compute \p out[i] = log(\p in[i]) for \p n integers.
+KERNEL_API void my_log_u32(const uint32_t *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = log_int<false>(in[i]);
+    }
+}
+
+/// Compute \p out[i] = log2(\p in[i]) for \p n integers.
+KERNEL_API void my_log2_u32(const uint32_t *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = log_int<true>(in[i]);
+    }
+}
+
+/// Compute \p out[i] = log(\p in[i]) for \p n integers.
+KERNEL_API void my_log_u64(const uint64_t *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = log_int<false>(in[i]);
+    }
+}
+
+/// Compute \p out[i] = log2(\p in[i]) for \p n integers.
+KERNEL_API void my_log2_u64(const uint64_t *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = log_int<true>(in[i]);
+    }
+}
+
+#endif // LOG_INT_H
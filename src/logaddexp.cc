@@ -0,0 +1,81 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "logaddexp.h"
+#include "util.h"
+
+// Use the stable libm formulation in double as the ground truth.
+float accurate_logaddexp(float a, float b) {
+    double hi = std::max<double>(a, b);
+    if (std::isinf(a) || std::isinf(b) || std::isnan(a) || std::isnan(b)) {
+        return (std::isnan(a) || std::isnan(b)) ? a + b : hi;
+    }
+    return hi + log1p(exp(-std::abs(double(a) - double(b))));
+}
+
+// The naive composition of two libm calls.
+float __attribute__((noinline)) libm_logaddexp(float a, float b) { return logf(expf(a) + expf(b)); }
+
+// Prints a lookup table of log1p(exp(-d)) and 1/(1+exp(d)) for d = i/32.
+void print_logaddexp_table() {
+    printf("inline constexpr uint64_t logaddexp_table[513 * 2] = {");
+    for (int i = 0; i <= 512; i++) {
+        double d = i / 32.;
+        double g = log1p(exp(-d));
+        double s = 1 / (1 + exp(d));
+        if (i % 2 == 0) {
+            printf("\n   ");
+        }
+        printf(" 0x%016lx, 0x%016lx,", bit_cast<uint64_t, double>(g), bit_cast<uint64_t, double>(s));
+    }
+    printf("\n};\n");
+}
+
+void check() {
+    float inf = INFINITY;
+    assert(my_logaddexp(0, 0) == float(log(2.)));
+    assert(my_logaddexp(-inf, 3) == 3);
+    assert(my_logaddexp(3, -inf) == 3);
+    assert(my_logaddexp(inf, -inf) == inf);
+    assert(my_logaddexp(-inf, -inf) == -inf);
+    assert(my_logaddexp(inf, inf) == inf);
+    assert(std::isnan(my_logaddexp(NAN, 1)));
+    assert(std::isnan(my_logaddexp(1, NAN)));
+    assert(my_logaddexp(1000, 0) == 1000);
+    assert(my_logaddexp(-1000, -1000) == float(-1000 + log(2.)));
+}
+
+int main(int argc, char **argv) {
+    // Print the table of logaddexp.h.
+    if (argc == 2 && std::string(argv[1]) == "--print-table") {
+        print_logaddexp_table();
+        return 0;
+    }
+    check();
+    // The log-probabilities of decoders are mostly in this range.
+    print_ulp_deltas(my_logaddexp, accurate_logaddexp, -100, 100, 1 << 13);
+    print_ulp_deltas(my_logaddexp, accurate_logaddexp, -1, 1, 1 << 13);
+
+    std::vector<float> iv1 = generate_test_vector<float>(-20., 0., 10000);
+    std::vector<float> iv2 = generate_test_vector<float>(-20., 0., 10000);
+    bench("my_logaddexp  ", my_logaddexp, iv1, iv2);
+    bench("libm_logaddexp", libm_logaddexp, iv1, iv2);
+
+    // Benchmark the batch entry point.
+    std::vector<float> out(iv1.size());
+    auto t1 = high_resolution_clock::now();
+    float sum = 0;
+    for (int iter = 0; iter < 10000; iter++) {
+        my_logaddexp(iv1.data(), iv2.data(), out.data(), out.size());
+        sum += out[iter % out.size()];
+    }
+    auto t2 = high_resolution_clock::now();
+    std::cout << "name = batch_logaddexp, sum = " << sum << ", time = "
+              << duration_cast<milliseconds>(t2 - t1).count() << "ms\n";
+    return 0;
+}
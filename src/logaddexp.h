@@ -0,0 +1,341 @@
+#ifndef LOGADDEXP_H
+#define LOGADDEXP_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "exp_accurate.h"
+#include "util.h"
+
+// A lookup table of pairs {log1p(exp(-d)), 1/(1+exp(d))} for d = i/32, in the
+// range [0 .. 16]. Generated with print_logaddexp_table().
+inline constexpr uint64_t logaddexp_table[513 * 2] = {
+    0x3fe62e42fefa39ef, 0x3fe0000000000000, 0x3fe5af42fc4f9aa5, 0x3fdf8002aa999a09,
+    0x3fe53242d452673b, 0x3fdf001553336a72, 0x3fe4b742271a9ace, 0x3fde8047efd07c32,
+    0x3fe43e4055056374, 0x3fde00aa6681fcf3, 0x3fe3c73c7f04b84d, 0x3fdd814c85836ef2,
+    0x3fe35235870e4f37, 0x3fdd023dfb7009ee, 0x3fe2df2a10a97d08, 0x3fdc838e4f996948,
+    0x3fe26e18819b6b47, 0x3fdc054cda8768fa, 0x3fe1feff02b0ef62, 0x3fdb8788bea8c9a3,
+    0x3fe191db80a53198, 0x3fdb0a50e13bdcf8, 0x3fe126abad2435a6, 0x3fda8db3e37618e3,
+    0x3fe0bd6cffe83c7a, 0x3fda11c01bf10223, 0x3fe0561cb7f0dd9c, 0x3fd99683906266be,
+    0x3fdfe16fb9a53f7e, 0x3fd91c0befa560db, 0x3fdf1a76803b86f6, 0x3fd8a2668c1911f6,
+    0x3fde5746fdb5c064, 0x3fd829a0565978de, 0x3fdd97da0637c5fc, 0x3fd7b1c5d856320d,
+    0x3fdcdc280b3fe295, 0x3fd73ae330ca5bdd, 0x3fdc24291f114a3d, 0x3fd6c5040f18404e,
+    0x3fdb6fd4f83e1f61, 0x3fd65033af8acd79, 0x3fdabf22f54dcffe, 0x3fd5dc7cd7fe4dfc,
+    0x3fda120a207c8cff, 0x3fd569e9d4f13cfc, 0x3fd9688133909968, 0x3fd4f88476fd7eab,
+    0x3fd8c27e9bc22ee1, 0x3fd4885610b9b828, 0x3fd81ff87db2b992, 0x3fd419677501f875,
+    0x3fd780e4b970359d, 0x3fd3abc0f5a661e4, 0x3fd6e538ee81852c, 0x3fd33f6a627e07ad,
+    0x3fd64cea7ff8a616, 0x3fd2d46b08dbbfe4, 0x3fd5b7ee9887c1ec, 0x3fd26ac9b3623eb1,
+    0x3fd5263a2e962a0b, 0x3fd2028caa346d91, 0x3fd497c208526b4c, 0x3fd19bb9b37e985d,
+    0x3fd40c7abfbec125, 0x3fd136561454ba86, 0x3fd38458c6b54f25, 0x3fd0d26691e1f159,
+    0x3fd2ff506ae1a836, 0x3fd06fef72e4dc51, 0x3fd27d55d9ad4dcd, 0x3fd00ef481748277,
+    0x3fd1fe5d241cf50a, 0x3fcf5ef21a125693, 0x3fd1825a429c84e0, 0x3fcea2ffd988f57c,
+    0x3fd1094118b7e62a, 0x3fcdea1703e813e0, 0x3fd0930578bee52a, 0x3fcd343b7593519a,
+    0x3fd01f9b27528a73, 0x3fcc81702a88e0d5, 0x3fcf5debbdb4f04a, 0x3fcbd1b7448ba0d0,
+    0x3fce8212a5c1fd98, 0x3fcb2512119b9871, 0x3fcdab9266a986bb, 0x3fca7b8112b35cb7,
+    0x3fccda525f5dea88, 0x3fc9d50402c11d4a, 0x3fcc0e39f3fa7016, 0x3fc93199ddd24bff,
+    0x3fcb4730939d0fc1, 0x3fc89140e86917a6, 0x3fca851dbe05056d, 0x3fc7f3f6b6f33fce,
+    0x3fc9c7e908f5420f, 0x3fc759b8355a1bb0, 0x3fc90f7a255a1246, 0x3fc6c281aea409c0,
+    0x3fc85bb8e4318cad, 0x3fc62e4ed49fde48, 0x3fc7ac8d3b369447, 0x3fc59d1ac7934c50,
+    0x3fc701df494e71de, 0x3fc50ee01de5accf, 0x3fc65b975ab93a81, 0x3fc48398ebc0f2d8,
+    0x3fc5b99ded056905, 0x3fc3fb3ecaa307bc, 0x3fc51bdbb2c73cff, 0x3fc375cae0da3729,
+    0x3fc4823997149aa0, 0x3fc2f335e8e7bfd6, 0x3fc3eca0c0c64ca4, 0x3fc2737838c40937,
+    0x3fc35afa957fabba, 0x3fc1f689c90068fd, 0x3fc2cd30bc7dcde3, 0x3fc17c623bc2cb27,
+    0x3fc2432d212f7c19, 0x3fc104f8e397f508, 0x3fc1bcd9f5974536, 0x3fc09044ca197df0,
+    0x3fc13a21b4791ace, 0x3fc01e3cb664f724, 0x3fc0baef2354f760, 0x3fbf5dae66c42f9d,
+    0x3fc03f2d54301d49, 0x3fbe84152bac31ae, 0x3fbf8d8f4e5d1686, 0x3fbdaf9a04857e3c,
+    0x3fbea35397fc9bca, 0x3fbce028e51fc25a, 0x3fbdbf7f862cbc60, 0x3fbc15ad76fcfe50,
+    0x3fbce1ebbd958699, 0x3fbb501323c99239, 0x3fbc0a71886f6366, 0x3fba8f451f6560c4,
+    0x3fbb38ead80ac87b, 0x3fb9d32e717db9b6, 0x3fba6d32460cd7a9, 0x3fb91bb9feb82ca2,
+    0x3fb9a72315646266, 0x3fb868d2916eca5b, 0x3fb8e69932fac2b3, 0x3fb7ba62e1feb8cf,
+    0x3fb82b713623f222, 0x3fb710559eaa51a9, 0x3fb7758860d13cc6, 0x3fb66a957310508f,
+    0x3fb6c4bc9f89e093, 0x3fb5c90d0f39da17, 0x3fb618ec892cda74, 0x3fb52ba72e4161b3,
+    0x3fb571f75e7f115f, 0x3fb4924e9c94aa01, 0x3fb4cfbd0988fcec, 0x3fb3fcee3dd449d2,
+    0x3fb4321e1cc6d13f, 0x3fb36b7112534847, 0x3fb398fbd22e24ad, 0x3fb2ddc23c398437,
+    0x3fb304380a0beda6, 0x3fb253cd044bb756, 0x3fb273b549bda06b, 0x3fb1cd7cde5bfc5a,
+    0x3fb1e756ba481caa, 0x3fb14abd6d65d0fa, 0x3fb15f0026cf0307, 0x3fb0cb7a875899e7,
+    0x3fb0da95faeef248, 0x3fb04fa03893b786, 0x3fb059fd40fd1361, 0x3fafae358e2e7e6f,
+    0x3fafba37405c85ac, 0x3faec3ad6ad8dc43, 0x3faec7aeb5501acc, 0x3faddf818a91d126,
+    0x3faddc2e96fb3aa0, 0x3fad018bf3dfa83a, 0x3facf785c9353a92, 0x3fac29a734a7a5d9,
+    0x3fac1984593bfc32, 0x3fab57ae65f9ba03, 0x3fab41fb794ce842, 0x3faa8b7d2f69cfbf,
+    0x3faa70bd7c24d59d, 0x3fa9c4efc9fc7ec7, 0x3fa9a59dd06a2a18, 0x3fa903e302acc623,
+    0x3fa8e070fc045701, 0x3fa848343c905445, 0x3fa8210c9763a72b, 0x3fa791c1729fbd98,
+    0x3fa7674748bc2a11, 0x3fa6e0693927dc1e, 0x3fa6b2f8bf365e63, 0x3fa6340abee96b4e,
+    0x3fa603f9ae18164b, 0x3fa58c85cdebca7a, 0x3fa55a23c7e7e925, 0x3fa4e9bacc07a61c,
+    0x3fa4b551b98d60fe, 0x3fa44b8abb2e1df4, 0x3fa4155f256fee1f, 0x3fa3b1d73970d2e7,
+    0x3fa37a289e968854, 0x3fa31c8280cf1c3d, 0x3fa2e38ba3c9c447, 0x3fa28b6f66cc78d9,
+    0x3fa251669aba0344, 0x3fa1fe815bd425bc, 0x3fa1c398cb2b452f, 0x3fa1759c6a6d98ae,
+    0x3fa13a025a280713, 0x3fa0f0a536457386, 0x3fa0b484453c7cc4, 0x3fa06f80fb0e5af4,
+    0x3fa033005dbb5952, 0x3f9fe42b1679e589, 0x3f9f6ab2881a8146, 0x3f9ef0929d44333a,
+    0x3f9e76e4c617c898, 0x3f9e040681ccad94, 0x3f9d8a5fd6d36db2, 0x3f9d1e55dfd28d63,
+    0x3f9ca4ed9e4e159c, 0x3f9c3f50f40f5a58, 0x3f9bc6597a2abc1f, 0x3f9b66c9189561d7,
+    0x3f9aee7038d2fdb9, 0x3f9a9490c1054030, 0x3f9a1d0010ba49e5, 0x3f99c87b769ef8cf,
+    0x3f9951d897c1103e, 0x3f99025dd432d853, 0x3f988ccabab8da0b, 0x3f98420d81f61caf,
+    0x3f97cda8b50a22e0, 0x3f978761313f225a, 0x3f971446087ca5f3, 0x3f96d230982c9b6a,
+    0x3f9660777522ba83, 0x3f9622546d3b1d50, 0x3f95b212f1684015, 0x3f9577a662cc1c17,
+    0x3f9508efa245836c, 0x3f94d20122a136ce, 0x3f9464e5d3966ed6, 0x3f943140494e874c,
+    0x3f93c5cef0964372, 0x3f93954061a678bc, 0x3f932b857c8005d8, 0x3f92fddee0217b95,
+    0x3f9295e50b53b653, 0x3f926afa1e43c2c3, 0x3f9204ca3ac05c5f, 0x3f91dc7156030d7c,
+    0x3f917812ab32dd48, 0x3f9152249d2e5a71, 0x3f90ef9cf90987dd, 0x3f90cbf4e0d93c85,
+    0x3f906b48b5ec3195, 0x3f9049c3e0cc6679, 0x3f8fd5ecc4916b40, 0x3f8f96e855f9c447,
+    0x3f8edd0ecde7360e, 0x3f8ea1d22e169145, 0x3f8debbc1dd939f9, 0x3f8db40d83986716,
+    0x3f8d01bb028d8df0, 0x3f8ccd6411b606fa, 0x3f8c1ed376679bcc, 0x3f8beda10c6ffc37,
+    0x3f8b42cf14648ff1, 0x3f8b149117e559fb, 0x3f8a6d790cbcbb72, 0x3f8a42023fc29f90,
+    0x3f899e9e19c9117e, 0x3f8975c3eecc3be2, 0x3f88d60c752bddcc, 0x3f88afa6e686004a,
+    0x3f881393cd3bc7c2, 0x3f87ef7d36f8ac26, 0x3f8757053ab02d6f, 0x3f87351a369696e0,
+    0x3f86a033368dd9b7, 0x3f8680527a405c3b, 0x3f85eef190531271, 0x3f85d0fbcd6a4f76,
+    0x3f8543156461f5ab, 0x3f8526ed2a635c41, 0x3f849c7512a81847, 0x3f8481feb2bde158,
+    0x3f83fae83582545b, 0x3f83e209a7daf6ea, 0x3f835e4798dbb280, 0x3f8346e863987b81,
+    0x3f82c66d318656ab, 0x3f82b07651222bd4, 0x3f82333414cd5776, 0x3f821e8fe5e5f5df,
+    0x3f81a478703e6584, 0x3f8191129aaba494, 0x3f811a1781aa27ea, 0x3f8107dce4cff00a,
+    0x3f8093ef8f5a329a, 0x3f8082ce2fa2ee21, 0x3f8011dfe07b7bf9, 0x3f8001c6d5e9d0bf,
+    0x3f7f27916b786f6e, 0x3f7f09503707a24b, 0x3f7e33168437fc5a, 0x3f7e16a84e64372e,
+    0x3f7d461347da5219, 0x3f7d2b5bf9050624, 0x3f7c604dbc0ca066, 0x3f7c4732ebb97518,
+    0x3f7b818da245a728, 0x3f7b69f67d638f8e, 0x3f7aa99c6ae2c37e, 0x3f7a93719b9ab674,
+    0x3f79d845289eda7f, 0x3f79c370bf9161df, 0x3f790d5484610c3a, 0x3f78f9c1e33d2e96,
+    0x3f784898b1611fd5, 0x3f78363476c064e7, 0x3f7789e1619fa06c, 0x3f77789956141b68,
+    0x3f76d0ffbaafa965, 0x3f76c0c2bef20e6a, 0x3f761dc64ad0685d, 0x3f760e8446fd3c76,
+    0x3f757008fe54624f, 0x3f7561b2d22850c0, 0x3f74c79d1554916f, 0x3f74ba248958de01,
+    0x3f74245919ad795c, 0x3f7417b0d14666dd, 0x3f738614d5445738, 0x3f737a3041942c54,
+    0x3f72eca948929bb8, 0x3f72e17c9c24b717, 0x3f7257f0a175e576, 0x3f724d70c4a60d99,
+    0x3f71c7c63242ba73, 0x3f71bde8b8558689, 0x3f713c0669184825, 0x3f7132c185fa25b5,
+    0x3f70b48ec7737a01, 0x3f70abd946147067, 0x3f70313dd9ffbf25, 0x3f70290f1342a5e3,
+    0x3f6f63e66147c069, 0x3f6f548605b09166, 0x3f6e6d1ead929e9b, 0x3f6e5eac3b4fcbf9,
+    0x3f6d7de797b8c898, 0x3f6d7054b1fc1257, 0x3f6c9605f80800aa, 0x3f6c89451f9896ef,
+    0x3f6bb540721e37ef, 0x3f6ba944f806e13c, 0x3f6adb5f672d976c, 0x3f6ad01d6037085d,
+    0x3f6a082ce8a69e36, 0x3f69fd992191da21, 0x3f693b74ab458d93, 0x3f6931849dbadf5d,
+    0x3f687503fa806c46, 0x3f686badc2a83389, 0x3f67b4a9ac52fa9d, 0x3f67abe3ff0e2c54,
+    0x3f66fa361566008d, 0x3f66f1f8371cd3fb, 0x3f66457afd8f6f56, 0x3f663dbcb98d400c,
+    0x3f65964b94a8df62, 0x3f658f0534fcd5a6, 0x3f64ec7c67ba02ac, 0x3f64e5a6ad949346,
+    0x3f6447e35674b30e, 0x3f64417772fa800f, 0x3f63a8578900529d, 0x3f63a24f168b684d,
+    0x3f630db166124301, 0x3f63080661db16b1, 0x3f6277ca89514701, 0x3f6272774d794222,
+    0x3f61e67dba01afad, 0x3f61e17cf7f97005, 0x3f6159a6e1f84450, 0x3f6154f39d3c1347,
+    0x3f60d12304d1e22e, 0x3f60ccb88df738b6, 0x3f604cd0376dde1c, 0x3f6048aa277d19bb,
+    0x3f5f991b2f527eb3, 0x3f5f914f977dedc0, 0x3f5ea07688b1ef8a, 0x3f5e9923b31547f9,
+    0x3f5daf74ab029429, 0x3f5da8934a0270d7, 0x3f5cc5d9a9913621, 0x3f5cbf62e08abbce,
+    0x3f5be36b6c47edb7, 0x3f5bdd58c8bf8275, 0x3f5b07f1a1773e03, 0x3f5b023d14b06053,
+    0x3f5a3335b00c0357, 0x3f5a2dd98903f08b, 0x3f596502aa2f0af4, 0x3f595ff98ff44513,
+    0x3f589d25404b4136, 0x3f58986a2cac5faa, 0x3f57db6bb47778d7, 0x3f57d6f9ef040487,
+    0x3f571fa5ce40e2d5, 0x3f571b78e7974ef7, 0x3f5669a4ced3632b, 0x3f5665b89c377f81,
+    0x3f55b93b657d0270, 0x3f55b58bfcb28afb, 0x3f550e3da489d00a, 0x3f550ac757ef00fd,
+    0x3f546880f6759baf, 0x3f5465405159ef72, 0x3f53c7dc1370ff7d, 0x3f53c4cdd6a477a5,
+    0x3f532c26f737461c, 0x3f53294815ced7f2, 0x3f52953ad732ca15, 0x3f529288737ebb72,
+    0x3f5202f218ed7ca4, 0x3f520069819eaf3b, 0x3f51752848cb533b, 0x3f5172c6f644aa91,
+    0x3f50ebba110c6b3a, 0x3f50e97da2dda510, 0x3f5066853114c34c, 0x3f50646b6b9c4311,
+    0x3f4fcad0e9eef2ee, 0x3f4fc6de7e515bae, 0x3f4ed0875a8717db, 0x3f4eccd21d1f7353,
+    0x3f4dddef4e20532b, 0x3f4dda738adf1189, 0x3f4cf2cc488d5ac9, 0x3f4cef8684bfcc70,
+    0x3f4c0ee3a850db9c, 0x3f4c0bd09f293fca, 0x3f4b31fc981d2df6, 0x3f4b2f193770652e,
+    0x3f4a5be000c4a797, 0x3f4a592965fa4d73, 0x3f498c587b972d01, 0x3f4989cbf0c90ef5,
+    0x3f48c3324529bcd4, 0x3f48c0cd3e6fd232, 0x3f48003b3084c857, 0x3f47fdfb496afc1f,
+    0x3f4743429ab643f9, 0x3f47412593d98a3d, 0x3f468c195ec471af, 0x3f468a1d1b94c95e,
+    0x3f45da91c9fe7d61, 0x3f45d8b44ea3a3d3, 0x3f452e7f90a81991, 0x3f452cbf0006d79b,
+    0x3f4487b7c2fd5f62, 0x3f4486125cdb77fc, 0x3f43e610c28c49e1, 0x3f43e484e1d130e2,
+    0x3f43496237e1386b, 0x3f4347ee50f1d458, 0x3f42b1850883f787, 0x3f42b027a7b7cc47,
+    0x3f421e534d42e269, 0x3f421d0b15711bf3, 0x3f418fa848c9c1b7, 0x3f418e73f1ecad82,
+    0x3f4105605e821e16, 0x3f41043eb46fb851, 0x3f407f5909bace3f, 0x3f407e48eaf11cc4,
+    0x3f3ffae1aa2932a2, 0x3f3ff8e263314415, 0x3f3eff0ea463ace6, 0x3f3efd2e55002287,
+    0x3f3e0afa234e0555, 0x3f3e0936eb6870c9, 0x3f3d1e673654aac0, 0x3f3d1cbf52e7db48,
+    0x3f3c391acc00d5e5, 0x3f3c378c95567439, 0x3f3b5adba34856a9, 0x3f3b59658b51c03e,
+    0x3f3a83723d5041c8, 0x3f3a8212ce18fdb0, 0x3f39b2a8cf9f02a5, 0x3f39b15ea9d743ea,
+    0x3f38e84b36ba6fc4, 0x3f38e715105830e4, 0x3f382426e92e9a46, 0x3f3823038c23f40a,
+    0x3f37660aeafa29f7, 0x3f3764f933ff9cec, 0x3f36adc7c15d2fe3, 0x3f36acc69eceabb5,
+    0x3f35fb2f67077130, 0x3f35fa3dd7d2f7a6, 0x3f354e1540a342d0, 0x3f354d32534815e6,
+    0x3f34a64e11ba2543, 0x3f34a578e357801e, 0x3f3403aff1f0650f, 0x3f3402e7ad62cf30,
+    0x3f336612429519ae, 0x3f3365561fa17242, 0x3f32cd4da483f14f, 0x3f32cc9ce70f5e22,
+    0x3f32393bee564b5a, 0x3f323895e5aa43d2, 0x3f31a9b822e13714, 0x3f31a91c28faefa3,
+    0x3f311e9e67fdfe4d, 0x3f311e0be0e88435, 0x3f3097cbfd9af650, 0x3f30974256d3560e,
+    0x3f30151f3512629a, 0x3f30149de4f53d8c, 0x3f2f2ceed18a8c8c, 0x3f2f2bfbdc0a8a96,
+    0x3f2e3769e7f0229f, 0x3f2e3685aa39565a, 0x3f2d497255de4e59, 0x3f2d489bebb67354,
+    0x3f2c62cca6929740, 0x3f2c620339921c53, 0x3f2b833f392c23ca, 0x3f2b8281ffe7dfb0,
+    0x3f2aaa92324cf1c0, 0x3f2aa9e06f8cd118, 0x3f29d88f6e2bdad9, 0x3f29d7e8702dbe72,
+    0x3f290d027313f2df, 0x3f290c6592da0190, 0x3f2847b8644de7eb, 0x3f28472504f7a276,
+    0x3f27887ff5702705, 0x3f2787f5839d974f, 0x3f26cf295e12a097, 0x3f26cea74f5107b0,
+    0x3f261b864de320df, 0x3f261b0c20229096, 0x3f256d69e11747f3, 0x3f256cf71a289dd9,
+    0x3f24c4a895394429, 0x3f24c43cc2540408, 0x3f2421183e4c87c7, 0x3f2420b2f39c1ba5,
+    0x3f23828ffc47c8d7, 0x3f238230d47fb3c9, 0x3f22e8e830e1ae97, 0x3f22e88eccd846ca,
+    0x3f2253fa75ada4a2, 0x3f2253a67bfcef62, 0x3f21c3a192865f99, 0x3f21c352af32b043,
+    0x3f2137b97443b210, 0x3f21376f5867b2b7, 0x3f20b01f23b96369, 0x3f20afd98537332e,
+    0x3f202cb0bcfccbe5, 0x3f202c6f5633e446, 0x3f1f5a9acdde1603, 0x3f1f5a1feced441b,
+    0x3f1e63aa96137bda, 0x3f1e633726debf8b, 0x3f1d74531ad858d0, 0x3f1d73e6a9ec9580,
+    0x3f1c8c588a4de48d, 0x3f1c8bf2ab3658e6, 0x3f1bab80e988767b, 0x3f1bab2136624a57,
+    0x3f1ad19406156b57, 0x3f1ad13a1f29cf15, 0x3f19fe5b67f2dedd, 0x3f19fe06f357564b,
+    0x3f1931a243f5bc3d, 0x3f193152ed323579, 0x3f186b356e9ac2fd, 0x3f186aeae6551f62,
+    0x3f17aae34f3f38b1, 0x3f17aa9d4aebf372, 0x3f16f07bd3be1952, 0x3f16f03a0d55bc6c,
+    0x3f163bd0646eb131, 0x3f163b929a27ce33, 0x3f158cb3d881a36b, 0x3f158c79cc8f0a12,
+    0x3f14e2fa6ab97738, 0x3f14e2c3e30c6824, 0x3f143e79ae7bdd40, 0x3f143e467489faf4,
+    0x3f139f088538f3eb, 0x3f139ed865c5b812, 0x3f13047f1425e728, 0x3f130451df0f6598,
+    0x3f126eb6ba485cb6, 0x3f126e8c425720f4, 0x3f11dd8a06d0320a, 0x3f11dd62218a073d,
+    0x3f1150d4afbd247a, 0x3f1150af353a9a85, 0x3f10c87388ce0efa, 0x3f10c8505392925b,
+    0x3f1044447ab77b40, 0x3f104423678bd7ba, 0x3f0f884cf53eab28, 0x3f0f880ed0dcfc72,
+    0x3f0e8ff303b747fc, 0x3f0e8fb8a3233ab4, 0x3f0d9f3d0be463ff, 0x3f0d9f0634b9fa9c,
+    0x3f0cb5eee1ae647b, 0x3f0cb5bb5d133548, 0x3f0bd3ce32d1ce45, 0x3f0bd39dcd3e2757,
+    0x3f0af8a2784ce55b, 0x3f0af8750158434c, 0x3f0a2434e83ff8a6, 0x3f0a240a32709c82,
+    0x3f095650683cd446, 0x3f09562848da4847, 0x3f088ec18001f05c, 0x3f088e9bceea4de6,
+    0x3f07cd564c9e0d19, 0x3f07cd32e41dd960, 0x3f0711de73f906e6, 0x3f0711bd30a57dff,
+    0x3f065c2b18bec68c, 0x3f065c0bd9526f44, 0x3f05ac0ecea949d4, 0x3f05abf173e2aed4,
+    0x3f05015d8f26d898, 0x3f050141fba945a1, 0x3f045becae59914d, 0x3f045bd2c68fb53c,
+    0x3f03bb92d06d8e55, 0x3f03bb7a7a6de491, 0x3f032027df42fad2, 0x3f03201102b5e09c,
+    0x3f028985006982c0, 0x3f02896f8670de67, 0x3f01f7848b6a9e58, 0x3f01f7705e8b0004,
+    0x3f016a0200604c48, 0x3f0169ef0c6b717e, 0x3f00e0d9fed5e187, 0x3f00e0c830d685dd,
+    0x3f005bea3cf0a7cc, 0x3f005bd983178eb2, 0x3effb622fdbc2b93, 0x3effb60390e074b0,
+    0x3efebc5f1d0afae2, 0x3efebc419796ad04, 0x3efdca4a66f63b0d, 0x3efdca2eab61caa5,
+    0x3efcdfa8566527e8, 0x3efcdf8e48f306f7, 0x3efbfc3e42dd7c48, 0x3efbfc25c97e5b40,
+    0x3efb1fd351da480c, 0x3efb1fbc5413050a, 0x3efa4a3068963251, 0x3efa4a1acf675c8d,
+    0x3ef97b201e459b7f, 0x3ef97b0bd4147286, 0x3ef8b26eaebd2ec9, 0x3ef8b25b9f3e0672,
+    0x3ef7efe9ed818dba, 0x3ef7efd805a38146, 0x3ef73361393cdaa2, 0x3ef733506716baab,
+    0x3ef67ca56f970021, 0x3ef67c95a2556857, 0x3ef5cb88e16dacbc, 0x3ef5cb7a09422f6c,
+    0x3ef51fdf47691122, 0x3ef51fd1557a67d4, 0x3ef4797db6ea8725, 0x3ef479709d45b85e,
+    0x3ef3d83a97525d9a, 0x3ef3d82e48dcc901, 0x3ef33bed979a1b4d, 0x3ef33be208045e32,
+    0x3ef2a46fa440a01d, 0x3ef2a464c7fa454b, 0x3ef2119add859fdc, 0x3ef21190a9b18e5a,
+    0x3ef1834a8df20647, 0x3ef18340f85ba390, 0x3ef0f95b212ae6c3, 0x3ef0f952203be176,
+    0x3ef073aa1b0caceb, 0x3ef073a1a5c365d9, 0x3eefe42c1e18aa8c, 0x3eefe41c39e5ba67,
+    0x3eeee8fd2fb90d84, 0x3eeee8ee42004fc9, 0x3eedf5889ea8ed3c, 0x3eedf57a987b82b8,
+    0x3eed09918d2d21b3, 0x3eed09846083c7ab, 0x3eec24dcfce9de3b, 0x3eec24d09c96e631,
+    0x3eeb4731c0236f1f, 0x3eeb47261fc59032, 0x3eea70586b7317cf, 0x3eea704d7f690c9a,
+    0x3ee9a01b47ec7f61, 0x3ee9a011054963df, 0x3ee8d64645b0352f, 0x3ee8d63ca2309910,
+    0x3ee812a6eee7f2b7, 0x3ee8129de0e79532, 0x3ee7550c5b295a2a, 0x3ee75503d999850e,
+    0x3ee69d47233c0ad8, 0x3ee69d3f259a832d, 0x3ee5eb29553ffd49, 0x3ee5eb21d38e8075,
+    0x3ee53e86693130f6, 0x3ee53e7f5bed75e7, 0x3ee4973335c5ccf6, 0x3ee4972c95e2014a,
+    0x3ee3f505e5a3eb52, 0x3ee3f4ffac7fa504, 0x3ee357d5ecec5ce7, 0x3ee357d0144df962,
+    0x3ee2bf7bff17c89e, 0x3ee2bf76812632a7, 0x3ee22bd205239da0, 0x3ee22bccdc6073d4,
+    0x3ee19cb3140c63ff, 0x3ee19cae3b4e7a02, 0x3ee111fb63930a83, 0x3ee111f6d6013f76,
+    0x3ee08b88454ae341, 0x3ee08b83fe574842, 0x3ee009381bee129f, 0x3ee0093417515c81,
+    0x3edf15d4a5ec8c11, 0x3edf15cd19570b6f, 0x3ede20feacef316a, 0x3ede20f795706beb,
+    0x3edd33b116773aac, 0x3edd33aa6cf71fcf, 0x3edc4db08e352742, 0x3edc4daa4c09addb,
+    0x3edb6ec39321c02f, 0x3edb6ebdb2083bd9, 0x3eda96b2691dd71e, 0x3eda96ace334b518,
+    0x3ed9c5470b033d21, 0x3ed9c541dac42246, 0x3ed8fa4d1d237590, 0x3ed8fa483d5db78e,
+    0x3ed83591e030c4e5, 0x3ed8358d4c04392b, 0x3ed776e4248e5608, 0x3ed776dfd766713d,
+    0x3ed6be143e044a40, 0x3ed6be1033938b5c, 0x3ed60af3f7d4a0fc, 0x3ed60af02c10436c,
+    0x3ed55d56892dfcc5, 0x3ed55d52f849ed5d, 0x3ed4b51089f9623a, 0x3ed4b50d306472d2,
+    0x3ed411f7e80024a2, 0x3ed411f4c2607aa0, 0x3ed373e3dc6749ae, 0x3ed373e0e79703e7,
+    0x3ed2daace17dc351, 0x3ed2daaa1a87d3ee, 0x3ed2462ca8daf37a, 0x3ed2462a0cf82aa5,
+    0x3ed1b63e11cb0134, 0x3ed1b63b9e5f45bb, 0x3ed12abd20069a91, 0x3ed12abad29e4d8d,
+    0x3ed0a386f2b3d12a, 0x3ed0a384c9015a38, 0x3ed02079bbadd1b8, 0x3ed02077b387512c,
+    0x3ecf42e96e229123, 0x3ecf42e59cdcdad3, 0x3ece4cb04616aca3, 0x3ece4cacb006ab83,
+    0x3ecd5e0a6fd210e8, 0x3ecd5e07116169dc, 0x3ecc76bc40cab385, 0x3ecc76b9169aaf50,
+    0x3ecb968be4679c5e, 0x3ecb9688eb4dc8a2, 0x3ecabd414d8b997d, 0x3ecabd3e828e9e09,
+    0x3ec9eaa62891d1e6, 0x3ec9eaa388e67720, 0x3ec91e85cdb8b68a, 0x3ec91e8356bf1a00,
+    0x3ec858ad33f7ec34, 0x3ec858aae338e081, 0x3ec798eae43de3ea, 0x3ec798e8b7687959,
+    0x3ec6df0eed11f14f, 0x3ec6df0ce1f924b6, 0x3ec62aead697c777, 0x3ec62ae8eb30550d,
+    0x3ec57c5196f15d34, 0x3ec57c4fc94fb520, 0x3ec4d31786fc514d, 0x3ec4d315d552abf0,
+    0x3ec42f125767fe10, 0x3ec42f10c0048e14, 0x3ec39019062181b1, 0x3ec39017876cc21f,
+    0x3ec2f603d41316a9, 0x3ec2f6026c8e333c, 0x3ec260ac3b342bc1, 0x3ec260aae97781f6,
+    0x3ec1cfece4e7bffa, 0x3ec1cfeba7a17755, 0x3ec143a1a0a699e3, 0x3ec143a0769951f3,
+    0x3ec0bba75af304dd, 0x3ec0bba642f497c5, 0x3ec037dc1493d159, 0x3ec037db0d8c2994,
+    0x3ebf703db428cd8c, 0x3ebf703bc5f8cdef, 0x3ebe789f770f8e6f, 0x3ebe789da6d085f6,
+    0x3ebd889f8918eb08, 0x3ebd889dd4fa7453, 0x3ebca001e91e7db9, 0x3ebca0004f6c564c,
+    0x3ebbbe8c6e95f11a, 0x3ebbbe8aedb644f7, 0x3ebae406bb06a3b2, 0x3ebae4055178735d,
+    0x3eba103a2bf1d13b, 0x3eba1038d84b70a2, 0x3eb942f1cd29bba6, 0x3eb942f08e176852,
+    0x3eb87bfa4b946974, 0x3eb87bf91fd6f6b0, 0x3eb7bb21e856aa44, 0x3eb7bb20cec241d1,
+    0x3eb700386c642c30, 0x3eb7003763df2259, 0x3eb64b0f1c71860e, 0x3eb64b0e23f33fe5,
+    0x3eb59b78ad45331b, 0x3eb59b77c3d51dc8, 0x3eb4f14938649436, 0x3eb4f1485d192c50,
+    0x3eb44c56311a21fe, 0x3eb44c55631809f5, 0x3eb3ac7659d21153, 0x3eb3ac75984b35fd,
+    0x3eb31181b9cac15a, 0x3eb3118103fd8bd5, 0x3eb27b5193165f30, 0x3eb27b50e84cf336,
+    0x3eb1e9c058eb3f8e, 0x3eb1e9bfb87ac58c, 0x3eb15ca9a640829b, 0x3eb15ca90f887cca,
+    0x3eb0d3ea34b4a8ed, 0x3eb0d3e9a71e52c8, 0x3eb04f5fd3bbd36a, 0x3eb04f5f4eb98ade,
+    0x3eaf9dd2c026f331, 0x3eaf9dd1c64062a8, 0x3eaea4cd76f2e675, 0x3eaea4cc8c305b33,
+    0x3eadb37189488602, 0x3eadb370acbf2a00, 0x3eacc9829ef540a6, 0x3eacc981cfc8783f,
+    0x3eabe6c63b109c39, 0x3eabe6c578712971, 0x3eab0b03ad5cb782, 0x3eab0b02f687eac1,
+    0x3eaa36040419f899, 0x3eaa36035858ede5, 0x3ea96791fe4a5c91, 0x3ea967915cf1449e,
+    0x3ea89f79fe60f94b, 0x3ea89f7966ce6d9c, 0x3ea7dd89fd5a5d3a, 0x3ea7dd896ef6beac,
+    0x3ea721917e3a931d, 0x3ea72190f8777240, 0x3ea66b6181eda950, 0x3ea66b61044537e7,
+    0x3ea5bacc7b87b492, 0x3ea5bacc057c3fbb, 0x3ea50fa644e15e64, 0x3ea50fa5d5fcd0dd,
+    0x3ea469c4138e2616, 0x3ea469c3ab619219, 0x3ea3c8fc6e2991ea, 0x3ea3c8fc0c4cc23d,
+    0x3ea32d2721f8a3bd, 0x3ea32d26c609b36f, 0x3ea2961d38dcf966, 0x3ea2961ce27ff1e1,
+    0x3ea203b8ef97159e, 0x3ea203b89e7592ae, 0x3ea175d5ac5561f6, 0x3ea175d5601e3b5b,
+    0x3ea0ec4ff58d8d90, 0x3ea0ec4fadf485cd, 0x3ea06705691dfef2, 0x3ea0670525db770a,
+    0x3e9fcba9676a426a, 0x3e9fcba8e90ba215, 0x3e9ed13b10f8ccfc, 0x3e9ed13a9a4232fd,
+    0x3e9dde813209d49c, 0x3e9dde80c284807d, 0x3e9cf33f1ae75de1, 0x3e9cf33eb223c107,
+    0x3e9c0f39f9d701ec, 0x3e9c0f39976c5002, 0x3e9b3238cc653675, 0x3e9b32386ff0fc9b,
+    0x3e9a5c04512469aa, 0x3e9a5c03fa4a2bf6, 0x3e998c66f9dc6194, 0x3e998c66a8453e8f,
+    0x3e98c32cde266ad6, 0x3e98c32c9180c493, 0x3e980023ae72fdbc, 0x3e98002366722834,
+    0x3e97431aa7759afa, 0x3e97431a63d18f5b, 0x3e968be285f3bb02, 0x3e968be24668cfa0,
+    0x3e95da4d7af3c3a7, 0x3e95da4d3f42684d, 0x3e952e2f20490fb1, 0x3e952e2ee8358e0c,
+    0x3e94875c6d7a2b67, 0x3e94875c38cc6b4a, 0x3e93e5abacfe7f86, 0x3e93e5ab7b81ced0,
+    0x3e9348f471d0ba0d, 0x3e9348f4435397ef, 0x3e92b10f8d535966, 0x3e92b10f61a744de,
+    0x3e921dd70584d303, 0x3e921dd6dc7e1c5b, 0x3e918f260b80e27d, 0x3e918f25e4f67f94,
+    0x3e9104d8f24ca164, 0x3e9104d8ce1804a2, 0x3e907ecd25eb1ad7, 0x3e907ecd03e80c9b,
+    0x3e8ff9c245703fcb, 0x3e8ff9c20589349b, 0x3e8efde8da0e6704, 0x3e8efde89e0680be,
+    0x3e8e09cf1208eb2d, 0x3e8e09ced9a41ced, 0x3e8d1d37e5ab0b1a, 0x3e8d1d37b0b0eb5e,
+    0x3e8c37e82df0c8bb, 0x3e8c37e7fc2c58fc, 0x3e8b59a695bcdbda, 0x3e8b59a666fc5382,
+    0x3e8a823b8b8320b6, 0x3e8a823b5f97bb58, 0x3e89b1713363ed2c, 0x3e89b1710a21bbbb,
+    0x3e88e71359b4d319, 0x3e88e71332f28ff5, 0x3e8822ef65f37223, 0x3e8822ef418a57cf,
+    0x3e8764d44e1f158f, 0x3e8764d42beab7e6, 0x3e86ac928a75f46b, 0x3e86ac926a541c39,
+    0x3e85f9fc0993036d, 0x3e85f9fbeb638c2c, 0x3e854ce424e95fcb, 0x3e854ce4088e177f,
+    0x3e84a51f959a71f0, 0x3e84a51f7af6faf6, 0x3e84028469a3fd85, 0x3e840284509db22d,
+    0x3e8364e9f9636a3a, 0x3e8364e9e1e14222, 0x3e82cc28dd6ba621, 0x3e82cc28c7561d2d,
+    0x3e82381ae4ab1706, 0x3e82381acfec15d7, 0x3e81a89b0adf242a, 0x3e81a89af761ea04,
+    0x3e811d856f52f544, 0x3e811d855d04034d, 0x3e8096b74be71667, 0x3e8096b73ab41c27,
+    0x3e80140eec5fc2a6, 0x3e80140edc378bb3, 0x3e7f2ad74bef5216, 0x3e7f2ad72d9417ad,
+    0x3e7e355b9e6a20f8, 0x3e7e355b81e5bc48,
+};
+
+/// Compute exp(-d) for d in the range [0 .. 710) in double precision. This is
+/// the range reduction of my_exp: -d = I1 + I2/256 + r, where r is small.
+inline double exp_neg_reduced(double d) {
+    double x = -d;
+    int Int1 = int(x);
+    x = x - Int1;
+    int Int2 = int(x * 256);
+    x = x - (double(Int2) / 256);
+    return approximate_exp_pol_around_zero(x) * EXP_TABLE[Int1 + 710] * EXP_TABLE_r256[Int2 + 256];
+}
+
+/// Compute g(d) = log1p(exp(-d)) for d in the range [0 .. 710).
+inline double log1p_exp_neg(double d) {
+    if (d >= 16) {
+        // Here t = exp(-d) is below 2^-23, and log1p(t) = t - t^2/2 + O(t^3).
+        double t = exp_neg_reduced(d);
+        return t * (1 - 0.5 * t);
+    }
+
+    // Split d into the nearest table point d0 = i/32, and the residual r in
+    // the range [-1/64 .. 1/64].
+    int i = int(d * 32 + 0.5);
+    double r = d - i * (1. / 32);
+    double g0 = bit_cast<double, uint64_t>(logaddexp_table[2 * i]);
+    double s = bit_cast<double, uint64_t>(logaddexp_table[2 * i + 1]);
+
+    // The derivatives of g are polynomials in the sigmoid s = 1/(1+exp(d)):
+    // With s1 = s(1-s): g' = -s, g'' = s1, g''' = -s1(1-2s), g'''' = s1(1-6s1)
+    // and g''''' = -s1(1-2s)(1-12s1). Evaluate the Taylor expansion of degree 5
+    // around d0. The error is below s * 2^-44.
+    double s1 = s * (1 - s);
+    double c2 = s1 * 0.5;
+    double c3 = s1 * (1 - 2 * s) * (-1. / 6);
+    double c4 = s1 * (1 - 6 * s1) * (1. / 24);
+    double c5 = s1 * (1 - 2 * s) * (1 - 12 * s1) * (-1. / 120);
+    return g0 + r * (-s + r * (c2 + r * (c3 + r * (c4 + r * c5))));
+}
+
+/// Compute log(exp(a) + exp(b)) as max(a, b) + log1p(exp(-|a - b|)).
+inline float logaddexp_impl(float a, float b) {
+    float hi = std::max(a, b);
+    // Handle NaN and the infinities, where the difference is not finite.
+    if (is_nan(a) || is_nan(b)) {
+        return (std::isnan(a) || std::isnan(b)) ? a + b : hi;
+    }
+
+    // The difference of two floats is exact in double.
+    double d = std::abs(double(a) - double(b));
+
+    // exp(-104) is below half of the smallest denormal, so the correction term
+    // can't change the result.
+    if (d >= 104) {
+        return hi;
+    }
+
+    return hi + log1p_exp_neg(d);
+}
+
+KERNEL_API float my_logaddexp(float a, float b) { return logaddexp_impl(a, b); }
+
+/// Compute \p out[i] = log(exp(\p a[i]) + exp(\p b[i])) for \p n elements.
+KERNEL_API void my_logaddexp(const float *a, const float *b, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = logaddexp_impl(a[i], b[i]);
+    }
+}
+
+#endif // LOGADDEXP_H
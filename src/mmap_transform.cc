@@ -0,0 +1,309 @@
+#include <cassert>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "exp_accurate.h"
+#include "log_accurate.h"
+#include "log_dd.h"
+#include "parallel.h"
+#include "util.h"
+
+// Apply log or exp to a raw binary column of floats or doubles on disk:
+//
+//   mmap_transform [-j threads] [--nt] log|exp f32|f64 input output
+//
+// The input and the output files are mapped to memory, and the tool streams
+// through them in windows, with the batch kernels on all the cores (see
+// parallel.h). Before the workers start on a window, the tool asks the kernel
+// to read ahead the next one, and after they finish, it drops the pages of the
+// input, and starts to write the output window back to the file. The output
+// pages of the previous window are released once they are written, so the
+// memory use is a few windows and not the size of the file. The output must
+// be a different file than the input, because it is truncated first.
+//
+// The double column supports log only, on my_log_double.
+
+// The size of a window, which is a multiple of the page size.
+constexpr size_t WindowBytes = 64 << 20;
+
+void __attribute__((noinline)) log_f64(const double *in, double *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = my_log_double(in[i]);
+    }
+}
+
+/// A read-only or a read-write mapping of a whole file.
+class MappedFile {
+    int fd_ = -1;
+    void *data_ = MAP_FAILED;
+    size_t size_ = 0;
+
+  public:
+    /// Map the file at \p path for reading, or create it with \p size bytes
+    /// and map it for writing if \p writable. The blocks of a writable file
+    /// are allocated up front, so the writes to the mapping don't fail with
+    /// SIGBUS when the disk is full.
+    MappedFile(const char *path, bool writable, size_t size = 0) {
+        fd_ = writable ? open(path, O_RDWR | O_CREAT | O_TRUNC, 0644) : open(path, O_RDONLY);
+        if (fd_ < 0) {
+            return;
+        }
+        if (writable) {
+            int err = size ? posix_fallocate(fd_, 0, size) : 0;
+            if (err != 0) {
+                errno = err;
+                return;
+            }
+        } else {
+            struct stat st;
+            if (fstat(fd_, &st) != 0) {
+                return;
+            }
+            size = st.st_size;
+        }
+        size_ = size;
+        if (size_ == 0) {
+            return;
+        }
+        int prot = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+        data_ = mmap(nullptr, size_, prot, MAP_SHARED, fd_, 0);
+        if (data_ != MAP_FAILED) {
+            madvise(data_, size_, MADV_SEQUENTIAL);
+        }
+    }
+    ~MappedFile() {
+        if (data_ != MAP_FAILED) {
+            munmap(data_, size_);
+        }
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /// @return True if the file is open and mapped. An empty file is valid,
+    /// and has no mapping.
+    bool valid() const { return fd_ >= 0 && (size_ == 0 || data_ != MAP_FAILED); }
+    char *data() const { return static_cast<char *>(data_); }
+    size_t size() const { return size_; }
+
+    /// Start to write the dirty pages in [offset .. offset + len) back to the
+    /// file, without waiting for the writes.
+    void start_write_back(size_t offset, size_t len) const {
+        sync_file_range(fd_, offset, len, SYNC_FILE_RANGE_WRITE);
+    }
+
+    /// Wait until the pages in [offset .. offset + len) are written to the
+    /// file, and release them from the mapping. The offset is a multiple of
+    /// the page size.
+    /// @return False if the write failed, with errno set.
+    bool release(size_t offset, size_t len) const {
+        if (len == 0) {
+            return true;
+        }
+        if (msync(data() + offset, len, MS_SYNC) != 0) {
+            return false;
+        }
+        madvise(data() + offset, len, MADV_DONTNEED);
+        return true;
+    }
+};
+
+/// Apply \p kernel to the elements of \p input and write them to \p output.
+/// Stores the number of seconds in \p sec.
+/// @return False if writing the output failed, with errno set.
+template <class FloatTy>
+bool transform(ThreadPool &pool, void (*kernel)(const FloatTy *, FloatTy *, size_t),
+               const MappedFile &input, const MappedFile &output, const ApplyOptions &opts,
+               double &sec) {
+    size_t n = input.size() / sizeof(FloatTy);
+    size_t window = WindowBytes / sizeof(FloatTy);
+    // The byte range of the output window that is being written back.
+    size_t pending = 0, pending_len = 0;
+    auto t1 = high_resolution_clock::now();
+    for (size_t first = 0; first < n; first += window) {
+        size_t len = std::min(window, n - first);
+        char *in_bytes = input.data() + first * sizeof(FloatTy);
+        // Read ahead the next window while the workers are on this one.
+        if (first + len < n) {
+            size_t next = std::min(window, n - first - len);
+            madvise(in_bytes + len * sizeof(FloatTy), next * sizeof(FloatTy), MADV_WILLNEED);
+        }
+        const FloatTy *in = reinterpret_cast<const FloatTy *>(in_bytes);
+        FloatTy *out = reinterpret_cast<FloatTy *>(output.data()) + first;
+        parallel_apply(pool, kernel, in, out, len, opts);
+        // The input pages of the window are not needed anymore.
+        madvise(in_bytes, len * sizeof(FloatTy), MADV_DONTNEED);
+        // Write this output window back while the workers are on the next
+        // one, and release the previous window, which has had a window of
+        // time to reach the disk.
+        output.start_write_back(first * sizeof(FloatTy), len * sizeof(FloatTy));
+        if (!output.release(pending, pending_len)) {
+            return false;
+        }
+        pending = first * sizeof(FloatTy);
+        pending_len = len * sizeof(FloatTy);
+    }
+    bool ok = output.release(pending, pending_len);
+    auto t2 = high_resolution_clock::now();
+    sec = duration<double>(t2 - t1).count();
+    return ok;
+}
+
+/// Transform the file at \p in_path into the file at \p out_path.
+/// @return zero on success, and prints an error otherwise.
+int run(ThreadPool &pool, const std::string &fn, const std::string &type, const char *in_path,
+        const char *out_path, const ApplyOptions &opts, bool quiet = false) {
+    size_t elem = type == "f64" ? sizeof(double) : sizeof(float);
+    // Opening the output truncates it, which would destroy the input if they
+    // are the same file, under any name.
+    struct stat in_st, out_st;
+    if (stat(in_path, &in_st) == 0 && stat(out_path, &out_st) == 0 &&
+        in_st.st_dev == out_st.st_dev && in_st.st_ino == out_st.st_ino) {
+        fprintf(stderr, "error: %s and %s are the same file\n", in_path, out_path);
+        return 1;
+    }
+    MappedFile input(in_path, false);
+    if (!input.valid()) {
+        fprintf(stderr, "error: can't map %s: %s\n", in_path, strerror(errno));
+        return 1;
+    }
+    if (input.size() % elem != 0) {
+        fprintf(stderr, "error: the size of %s is not a multiple of %zu\n", in_path, elem);
+        return 1;
+    }
+    MappedFile output(out_path, true, input.size());
+    if (!output.valid()) {
+        fprintf(stderr, "error: can't map %s: %s\n", out_path, strerror(errno));
+        return 1;
+    }
+
+    double sec = 0;
+    bool ok;
+    if (type == "f32") {
+        void (*kernel)(const float *, float *, size_t) = my_exp;
+        if (fn == "log") {
+            kernel = my_log;
+        }
+        ok = transform<float>(pool, kernel, input, output, opts, sec);
+    } else {
+        ok = transform<double>(pool, log_f64, input, output, opts, sec);
+    }
+    if (!ok) {
+        fprintf(stderr, "error: can't write %s: %s\n", out_path, strerror(errno));
+        return 1;
+    }
+    if (!quiet) {
+        double gb = 2. * input.size() / 1e9;
+        printf("%s %s: %zu elements, %.3f sec, %.2f GB/s\n", fn.c_str(), type.c_str(),
+               input.size() / elem, sec, gb / std::max(sec, 1e-9));
+    }
+    return 0;
+}
+
+/// Write \p n floats to \p path, transform the file, and compare the output
+/// to the scalar kernel.
+void check_file(ThreadPool &pool, const std::string &fn, size_t n, bool nt) {
+    std::string in_path = "/tmp/mmap_transform_in.bin", out_path = "/tmp/mmap_transform_out.bin";
+    std::vector<float> in = generate_test_vector<float>(-100, 100, n);
+    FILE *f = fopen(in_path.c_str(), "wb");
+    assert(f);
+    size_t written = fwrite(in.data(), sizeof(float), n, f);
+    assert(written == n);
+    fclose(f);
+
+    ApplyOptions opts;
+    opts.non_temporal = nt;
+    int res = run(pool, fn, "f32", in_path.c_str(), out_path.c_str(), opts, true);
+    assert(res == 0);
+
+    std::vector<float> out(n);
+    f = fopen(out_path.c_str(), "rb");
+    assert(f);
+    size_t read = fread(out.data(), sizeof(float), n, f);
+    assert(read == n);
+    fclose(f);
+    for (size_t i = 0; i < n; i++) {
+        float r = fn == "log" ? my_log(in[i]) : my_exp(in[i]);
+        assert(memcmp(&r, &out[i], sizeof(float)) == 0);
+    }
+    unlink(in_path.c_str());
+    unlink(out_path.c_str());
+}
+
+void check() {
+    ThreadPool pool(3);
+    for (size_t n : { 0, 1, 1000, 100003 }) {
+        check_file(pool, "log", n, false);
+        check_file(pool, "exp", n, true);
+    }
+
+    // The tool refuses to write the output over the input, also through a
+    // link, and leaves the input unchanged.
+    std::string path = "/tmp/mmap_transform_same.bin", link = "/tmp/mmap_transform_link.bin";
+    std::vector<float> in = generate_test_vector<float>(1, 2, 1000);
+    FILE *f = fopen(path.c_str(), "wb");
+    assert(f);
+    size_t written = fwrite(in.data(), sizeof(float), in.size(), f);
+    assert(written == in.size());
+    fclose(f);
+    unlink(link.c_str());
+    int res = symlink(path.c_str(), link.c_str());
+    assert(res == 0);
+    ApplyOptions opts;
+    fprintf(stderr, "(expect two errors)\n");
+    assert(run(pool, "log", "f32", path.c_str(), path.c_str(), opts, true) == 1);
+    assert(run(pool, "log", "f32", path.c_str(), link.c_str(), opts, true) == 1);
+    struct stat st;
+    res = stat(path.c_str(), &st);
+    assert(res == 0 && size_t(st.st_size) == in.size() * sizeof(float));
+    unlink(link.c_str());
+    unlink(path.c_str());
+}
+
+int usage() {
+    fprintf(stderr, "usage: mmap_transform [-j threads] [--nt] log|exp f32|f64 input output\n"
+                    "       mmap_transform --check\n");
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    unsigned threads = std::thread::hardware_concurrency();
+    ApplyOptions opts;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--check") {
+            check();
+            printf("ok\n");
+            return 0;
+        } else if (arg == "--nt") {
+            opts.non_temporal = true;
+        } else if (arg == "-j" && i + 1 < argc) {
+            threads = std::max(atoi(argv[++i]), 1);
+        } else {
+            args.push_back(arg);
+        }
+    }
+    if (args.size() != 4 || (args[0] != "log" && args[0] != "exp") ||
+        (args[1] != "f32" && args[1] != "f64")) {
+        return usage();
+    }
+    if (args[0] == "exp" && args[1] == "f64") {
+        fprintf(stderr, "error: exp supports f32 only\n");
+        return 1;
+    }
+
+    ThreadPool pool(threads, true);
+    return run(pool, args[0], args[1], args[2].c_str(), args[3].c_str(), opts);
+}
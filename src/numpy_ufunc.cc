@@ -0,0 +1,118 @@
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include <numpy/arrayobject.h>
+#include <numpy/ufuncobject.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "exp_accurate.h"
+#include "log_accurate.h"
+#include "log_dd.h"
+#include "util.h"
+
+// A CPython extension module, fastlog, that registers the batch kernels as
+// the NumPy ufuncs fast_log and fast_exp:
+//
+//   >>> import numpy as np, fastlog
+//   >>> y = fastlog.fast_log(x)
+//   >>> fastlog.fast_exp(x, out=x)
+//
+// The ufunc machinery calls the loops below on the buffers of the arrays, so
+// there is no copy, and any object with the buffer protocol is accepted. It
+// also releases the GIL around the loops of the large arrays, because the
+// loops don't use the Python API. The contiguous arrays go straight to the
+// batch kernels, and the strided arrays go through a block on the stack.
+//
+// fast_log has float32 and float64 loops, on my_log and my_log_double.
+// fast_exp has a float32 loop only, on my_exp. NumPy does not cast float64
+// inputs down to float32 by itself, because the cast is not safe, so
+// fast_exp raises a TypeError on them. Pass x.astype(np.float32) instead,
+// or dtype=np.float32 to cast with the same_kind rule.
+
+void log_f64(const double *in, double *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = my_log_double(in[i]);
+    }
+}
+
+/// The ufunc loop of the batch kernel \p Batch.
+template <class FloatTy, void (*Batch)(const FloatTy *, FloatTy *, size_t)>
+void strided_loop(char **args, const npy_intp *dimensions, const npy_intp *steps, void *) {
+    char *in = args[0], *out = args[1];
+    npy_intp n = dimensions[0];
+    npy_intp in_step = steps[0], out_step = steps[1];
+
+    // NumPy passes either the same buffer or disjoint ones, and the batch
+    // kernels run in place.
+    bool aligned = (uintptr_t(in) | uintptr_t(out)) % alignof(FloatTy) == 0;
+    if (in_step == sizeof(FloatTy) && out_step == sizeof(FloatTy) && aligned) {
+        Batch(reinterpret_cast<const FloatTy *>(in), reinterpret_cast<FloatTy *>(out), n);
+        return;
+    }
+
+    constexpr npy_intp BlockSize = 1024;
+    FloatTy block_in[BlockSize], block_out[BlockSize];
+    for (npy_intp first = 0; first < n; first += BlockSize) {
+        npy_intp len = std::min(BlockSize, n - first);
+        for (npy_intp i = 0; i < len; i++) {
+            memcpy(&block_in[i], in + (first + i) * in_step, sizeof(FloatTy));
+        }
+        Batch(block_in, block_out, len);
+        for (npy_intp i = 0; i < len; i++) {
+            memcpy(out + (first + i) * out_step, &block_out[i], sizeof(FloatTy));
+        }
+    }
+}
+
+static PyUFuncGenericFunction log_loops[] = { strided_loop<float, my_log>,
+                                              strided_loop<double, log_f64> };
+static char log_types[] = { NPY_FLOAT, NPY_FLOAT, NPY_DOUBLE, NPY_DOUBLE };
+static void *log_data[] = { nullptr, nullptr };
+
+static PyUFuncGenericFunction exp_loops[] = { strided_loop<float, my_exp> };
+static char exp_types[] = { NPY_FLOAT, NPY_FLOAT };
+static void *exp_data[] = { nullptr };
+
+static PyMethodDef fastlog_methods[] = { { nullptr, nullptr, 0, nullptr } };
+
+static PyModuleDef fastlog_module = {
+    PyModuleDef_HEAD_INIT, "fastlog", "Fast log and exp ufuncs.", -1, fastlog_methods,
+};
+
+/// Create \p name as a unary ufunc, and add it to \p module.
+/// @return False on failure, with the Python error set.
+static bool add_ufunc(PyObject *module, const char *name, const char *doc,
+                      PyUFuncGenericFunction *loops, void **data, char *types, int num_types) {
+    PyObject *ufunc = PyUFunc_FromFuncAndData(loops, data, types, num_types, 1, 1, PyUFunc_None,
+                                              name, doc, 0);
+    if (!ufunc) {
+        return false;
+    }
+    if (PyModule_AddObject(module, name, ufunc) < 0) {
+        Py_DECREF(ufunc);
+        return false;
+    }
+    return true;
+}
+
+PyMODINIT_FUNC PyInit_fastlog(void) {
+    import_array();
+    import_umath();
+
+    PyObject *module = PyModule_Create(&fastlog_module);
+    if (!module) {
+        return nullptr;
+    }
+    if (!add_ufunc(module, "fast_log", "Natural logarithm, element-wise.", log_loops, log_data,
+                   log_types, 2) ||
+        !add_ufunc(module, "fast_exp", "Exponential, element-wise.", exp_loops, exp_data,
+                   exp_types, 1)) {
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
+}
@@ -0,0 +1,84 @@
+# Check and benchmark the fastlog extension module. Build it first with:
+# make fastlog
+import threading
+import timeit
+
+import numpy as np
+
+import fastlog
+
+
+def check():
+    x = np.random.default_rng(42).uniform(0.01, 100, 100001).astype(np.float32)
+    ref = np.log(x.astype(np.float64))
+    # my_log is within 1 ULP of the correctly rounded result.
+    assert np.max(np.abs(fastlog.fast_log(x) - ref) / np.abs(np.spacing(ref.astype(np.float32)))) <= 1
+    assert np.allclose(fastlog.fast_exp(x[:1000] / 10), np.exp(x[:1000] / 10), rtol=2 ** -22)
+    assert np.allclose(fastlog.fast_log(x.astype(np.float64)), ref, rtol=2 ** -51)
+
+    # fast_exp has no float64 loop, and NumPy does not cast the float64
+    # inputs to float32 implicitly. An explicit float32 dtype casts them.
+    d = (x[:1000] / 10).astype(np.float64)
+    try:
+        fastlog.fast_exp(d)
+        assert False, "fast_exp accepted float64 inputs"
+    except TypeError:
+        pass
+    r = fastlog.fast_exp(d, dtype=np.float32)
+    assert r.dtype == np.float32 and np.array_equal(r, fastlog.fast_exp(d.astype(np.float32)))
+
+    # The special values.
+    s = np.array([0, -1, np.inf, -np.inf, np.nan, 1e-45], np.float32)
+    with np.errstate(invalid="ignore"):
+        r = fastlog.fast_log(s)
+    assert r[0] == -np.inf and np.isnan(r[1]) and r[2] == np.inf and np.isnan(r[3])
+    assert np.isnan(r[4]) and abs(r[5] - np.log(np.float64(s[5]))) <= abs(np.spacing(r[5]))
+
+    # The special values in place, where the kernels fix up the results.
+    with np.errstate(invalid="ignore"):
+        fastlog.fast_log(s, out=s)
+    assert np.array_equal(s, r, equal_nan=True)
+    e = np.array([10, -100, 100, 1, np.nan], np.float32)
+    with np.errstate(over="ignore", invalid="ignore"):
+        r = fastlog.fast_exp(e)
+        fastlog.fast_exp(e, out=e)
+    assert np.array_equal(e, r, equal_nan=True)
+
+    # The strided, the in-place, the non-contiguous and the buffer inputs
+    # match the contiguous ones.
+    y = fastlog.fast_log(x)
+    assert np.array_equal(fastlog.fast_log(x[::3]), y[::3])
+    out = np.empty(2 * len(x), np.float32)
+    fastlog.fast_log(x, out=out[::2])
+    assert np.array_equal(out[::2], y)
+    z = x.copy()
+    fastlog.fast_log(z, out=z)
+    assert np.array_equal(z, y)
+    m = np.stack([x[:1000], x[1000:2000]]).T
+    assert np.array_equal(fastlog.fast_log(m), np.stack([y[:1000], y[1000:2000]]).T)
+    assert np.array_equal(fastlog.fast_log(memoryview(x)), y)
+
+
+def bench():
+    x = np.random.default_rng(1).uniform(0.01, 1000, 1 << 24).astype(np.float32)
+    e = np.random.default_rng(2).uniform(-20, 20, 1 << 24).astype(np.float32)
+    out = np.empty_like(x)
+    for name, fn, arr in [("fast_log", fastlog.fast_log, x), ("np.log  ", np.log, x),
+                          ("fast_exp", fastlog.fast_exp, e), ("np.exp  ", np.exp, e)]:
+        t = min(timeit.repeat(lambda: fn(arr, out=out), number=1, repeat=5))
+        print("name = %s, time = %dms" % (name, t * 1000))
+
+    # The loops release the GIL, so the threads run in parallel on the halves.
+    half = len(x) // 2
+    threads = [threading.Thread(target=fastlog.fast_log, args=(x[i * half:(i + 1) * half],),
+                                kwargs={"out": out[i * half:(i + 1) * half]}) for i in range(2)]
+    t = timeit.default_timer()
+    for th in threads:
+        th.start()
+    for th in threads:
+        th.join()
+    print("name = fast_log_2_threads, time = %dms" % ((timeit.default_timer() - t) * 1000))
+
+
+check()
+bench()
@@ -0,0 +1,107 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "activation.h"
+#include "log_float.h"
+#include "log_int.h"
+#include "parallel.h"
+#include "util.h"
+
+// The roofline of the memory system: a kernel that only moves the data.
+void __attribute__((noinline)) copy_kernel(const float *in, float *out, size_t n) {
+    memcpy(out, in, n * sizeof(float));
+}
+
+/// Check that parallel_apply matches one call of \p kernel on the whole array.
+template <class InTy>
+void check_apply(ThreadPool &pool, void (*kernel)(const InTy *, float *, size_t),
+                 const std::vector<InTy> &in, const ApplyOptions &opts) {
+    std::vector<float> expected(in.size()), out(in.size(), -1);
+    kernel(in.data(), expected.data(), in.size());
+    parallel_apply(pool, kernel, in.data(), out.data(), in.size(), opts);
+    assert(memcmp(expected.data(), out.data(), in.size() * sizeof(float)) == 0);
+}
+
+void check() {
+    ApplyOptions small;
+    small.chunk_size = 1000;
+    ApplyOptions streaming = small;
+    streaming.non_temporal = true;
+
+    // More workers than cores, so that the ranges are preempted and stolen.
+    for (unsigned threads : { 1, 3, 8 }) {
+        ThreadPool pool(threads);
+        for (size_t n : { 0, 1, 999, 1000, 12345, 100000 }) {
+            std::vector<float> fv = generate_test_vector<float>(-100, 100, n);
+            std::vector<uint32_t> uv(n);
+            for (size_t i = 0; i < n; i++) {
+                uv[i] = uint32_t(i * 2654435761u);
+            }
+            for (const ApplyOptions &opts : { small, streaming }) {
+                check_apply(pool, my_log_float, fv, opts);
+                check_apply(pool, my_sigmoid, fv, opts);
+                check_apply(pool, my_log_u32, uv, opts);
+            }
+        }
+    }
+
+    // The first-touch allocation zeroes the array.
+    ThreadPool pool(3);
+    float *p = alloc_first_touch<float>(pool, 12345, small);
+    for (size_t i = 0; i < 12345; i++) {
+        assert(p[i] == 0);
+    }
+    std::free(p);
+}
+
+/// Benchmark \p kernel on \p n elements, and report the bandwidth of the
+/// input and the output.
+void bench_apply(const std::string &name, ThreadPool *pool,
+                 void (*kernel)(const float *, float *, size_t), const float *in, float *out,
+                 size_t n, const ApplyOptions &opts = {}) {
+    constexpr int Iterations = 10;
+    auto t1 = high_resolution_clock::now();
+    for (int iter = 0; iter < Iterations; iter++) {
+        if (pool) {
+            parallel_apply(*pool, kernel, in, out, n, opts);
+        } else {
+            kernel(in, out, n);
+        }
+    }
+    auto t2 = high_resolution_clock::now();
+    double sec = duration<double>(t2 - t1).count();
+    double gb = double(Iterations) * n * 2 * sizeof(float) / 1e9;
+    std::cout << "name = " << name << ", sum = " << out[n / 3] << ", time = "
+              << duration_cast<milliseconds>(t2 - t1).count() << "ms, " << gb / sec << " GB/s\n";
+}
+
+int main(int argc, char **argv) {
+    check();
+
+    // 256MB of input and 256MB of output, far beyond the caches.
+    constexpr size_t N = 1 << 26;
+    ThreadPool pool(std::thread::hardware_concurrency(), true);
+    ApplyOptions streaming;
+    streaming.non_temporal = true;
+    float *in = alloc_first_touch<float>(pool, N);
+    float *out = alloc_first_touch<float>(pool, N);
+    std::vector<float> iv = generate_test_vector<float>(0.01, 1000., 1 << 16);
+    for (size_t i = 0; i < N; i++) {
+        in[i] = iv[i % iv.size()];
+    }
+
+    std::cout << "Workers: " << pool.size() << "\n";
+    bench_apply("serial_copy          ", nullptr, copy_kernel, in, out, N);
+    bench_apply("parallel_copy        ", &pool, copy_kernel, in, out, N);
+    bench_apply("parallel_copy_nt     ", &pool, copy_kernel, in, out, N, streaming);
+    bench_apply("serial_my_log_float  ", nullptr, my_log_float, in, out, N);
+    bench_apply("parallel_my_log_float", &pool, my_log_float, in, out, N);
+    bench_apply("parallel_log_float_nt", &pool, my_log_float, in, out, N, streaming);
+    std::free(in);
+    std::free(out);
+    return 0;
+}
@@ -0,0 +1,235 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <immintrin.h>
+#include <mutex>
+#include <new>
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// A parallel apply engine for the batch kernels, for the column transforms
+// that are too large for one core: a single core runs the vectorized kernels
+// faster than it can stream the arrays from memory, so the transform needs
+// the bandwidth of all the cores of the socket.
+//
+// The array is split into chunks that fit in the L2 cache, and each worker
+// owns a contiguous range of the chunks. A worker that finishes its range
+// steals the remaining chunks of the other workers, so a slow core or a
+// preempted thread doesn't hold the whole transform. The ranges are the same
+// in every call for the same pool and size, which is what makes the
+// first-touch placement of alloc_first_touch() work: the pages of a range are
+// on the NUMA node of the worker that processes the range.
+
+/// A fixed set of worker threads, that run one job at a time. The threads are
+/// created once and wait on a condition variable between the jobs, so a job
+/// costs a wake-up and not a thread creation.
+class ThreadPool {
+    std::vector<std::thread> threads_;
+    // Serializes the callers of run().
+    std::mutex run_lock_;
+    std::mutex lock_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    const std::function<void(unsigned)> *job_ = nullptr;
+    uint64_t generation_ = 0;
+    unsigned running_ = 0;
+    bool stop_ = false;
+
+    void work(unsigned tid) {
+        uint64_t seen = 0;
+        while (true) {
+            const std::function<void(unsigned)> *job;
+            {
+                std::unique_lock<std::mutex> guard(lock_);
+                start_.wait(guard, [&] { return stop_ || generation_ != seen; });
+                if (stop_) {
+                    return;
+                }
+                seen = generation_;
+                job = job_;
+            }
+            (*job)(tid);
+            std::lock_guard<std::mutex> guard(lock_);
+            if (--running_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+  public:
+    /// Start \p num_threads workers. If \p pin is set, worker i runs only on
+    /// CPU i, which keeps it on the NUMA node of the pages that it touched.
+    explicit ThreadPool(unsigned num_threads = std::thread::hardware_concurrency(),
+                        bool pin = false) {
+        num_threads = std::max(num_threads, 1u);
+        unsigned num_cpus = std::max(std::thread::hardware_concurrency(), 1u);
+        for (unsigned i = 0; i < num_threads; i++) {
+            threads_.emplace_back(&ThreadPool::work, this, i);
+            if (pin) {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(i % num_cpus, &set);
+                pthread_setaffinity_np(threads_[i].native_handle(), sizeof(set), &set);
+            }
+        }
+    }
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto &t : threads_) {
+            t.join();
+        }
+    }
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    unsigned size() const { return threads_.size(); }
+
+    /// Run \p job(tid) on every worker, and wait for all of them to finish.
+    void run(const std::function<void(unsigned)> &job) {
+        std::lock_guard<std::mutex> serial(run_lock_);
+        std::unique_lock<std::mutex> guard(lock_);
+        job_ = &job;
+        running_ = size();
+        generation_++;
+        start_.notify_all();
+        done_.wait(guard, [&] { return running_ == 0; });
+        job_ = nullptr;
+    }
+};
+
+struct ApplyOptions {
+    /// The number of elements in a chunk. The default chunk of floats is
+    /// 64KB of input and 64KB of output, which stays in the L2 cache.
+    size_t chunk_size = 16384;
+    /// Write the output with non-temporal stores, which bypass the cache. The
+    /// output of a large transform is not read again soon, and the streaming
+    /// stores save the read of each output line before it is written.
+    bool non_temporal = false;
+};
+
+/// @return the range of the chunks [first .. last) that worker \p tid of
+/// \p num_workers owns, out of \p num_chunks.
+inline std::pair<size_t, size_t> owned_chunks(size_t num_chunks, unsigned tid,
+                                              unsigned num_workers) {
+    return { num_chunks * tid / num_workers, num_chunks * (tid + 1) / num_workers };
+}
+
+/// Copy \p bytes from \p src to \p dst with non-temporal stores. The edges
+/// that are not aligned to the vector width are copied with regular stores.
+inline void stream_copy(void *dst, const void *src, size_t bytes) {
+#ifdef __AVX__
+    typedef __m256i VecTy;
+#else
+    typedef __m128i VecTy;
+#endif
+    constexpr size_t Width = sizeof(VecTy);
+    char *d = static_cast<char *>(dst);
+    const char *s = static_cast<const char *>(src);
+    size_t head = std::min(bytes, (Width - uintptr_t(d) % Width) % Width);
+    memcpy(d, s, head);
+    d += head;
+    s += head;
+    bytes -= head;
+    for (; bytes >= Width; bytes -= Width, d += Width, s += Width) {
+#ifdef __AVX__
+        _mm256_stream_si256(reinterpret_cast<VecTy *>(d),
+                            _mm256_loadu_si256(reinterpret_cast<const VecTy *>(s)));
+#else
+        _mm_stream_si128(reinterpret_cast<VecTy *>(d),
+                         _mm_loadu_si128(reinterpret_cast<const VecTy *>(s)));
+#endif
+    }
+    memcpy(d, s, bytes);
+}
+
+/// Apply the batch kernel \p kernel to the \p n elements of \p in, and write
+/// the results to \p out, on all the workers of \p pool. The kernel is called
+/// on one chunk at a time, and must not depend on the position of the chunk.
+template <class InTy, class OutTy>
+void parallel_apply(ThreadPool &pool, void (*kernel)(const InTy *, OutTy *, size_t),
+                    const InTy *in, OutTy *out, size_t n, const ApplyOptions &opts = {}) {
+    size_t chunk = std::max<size_t>(opts.chunk_size, 1);
+    size_t num_chunks = (n + chunk - 1) / chunk;
+    unsigned num_workers = pool.size();
+
+    // The next chunk of each range, on a separate cache line. The thieves
+    // take chunks from the same cursor as the owner.
+    struct alignas(64) Cursor {
+        std::atomic<size_t> next;
+        size_t end;
+    };
+    std::vector<Cursor> cursors(num_workers);
+    for (unsigned i = 0; i < num_workers; i++) {
+        auto range = owned_chunks(num_chunks, i, num_workers);
+        cursors[i].next.store(range.first, std::memory_order_relaxed);
+        cursors[i].end = range.second;
+    }
+
+    pool.run([&](unsigned tid) {
+        // The non-temporal path writes each chunk to a buffer in the cache,
+        // and streams the buffer to the output.
+        std::vector<OutTy> buffer(opts.non_temporal ? std::min(chunk, n) : 0);
+        // Start with the own range, and then visit the ranges of the others.
+        for (unsigned k = 0; k < num_workers; k++) {
+            Cursor &cursor = cursors[(tid + k) % num_workers];
+            while (true) {
+                size_t c = cursor.next.fetch_add(1, std::memory_order_relaxed);
+                if (c >= cursor.end) {
+                    break;
+                }
+                size_t first = c * chunk;
+                size_t len = std::min(chunk, n - first);
+                if (opts.non_temporal) {
+                    kernel(in + first, buffer.data(), len);
+                    stream_copy(out + first, buffer.data(), len * sizeof(OutTy));
+                } else {
+                    kernel(in + first, out + first, len);
+                }
+            }
+        }
+        if (opts.non_temporal) {
+            // Order the streaming stores before the stores that follow the job.
+            _mm_sfence();
+        }
+    });
+}
+
+/// Allocate an array of \p n elements, aligned to a page, for the input or the
+/// output of parallel_apply() with the same \p pool and \p opts. Each worker
+/// zeroes the chunks that it owns, and Linux places each page on the NUMA node
+/// of the thread that touches it first. Release the array with std::free().
+template <class T>
+T *alloc_first_touch(ThreadPool &pool, size_t n, const ApplyOptions &opts = {}) {
+    constexpr size_t PageSize = 4096;
+    size_t bytes = std::max<size_t>((n * sizeof(T) + PageSize - 1) / PageSize * PageSize, PageSize);
+    T *ptr = static_cast<T *>(std::aligned_alloc(PageSize, bytes));
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    size_t chunk = std::max<size_t>(opts.chunk_size, 1);
+    size_t num_chunks = (n + chunk - 1) / chunk;
+    pool.run([&](unsigned tid) {
+        auto range = owned_chunks(num_chunks, tid, pool.size());
+        size_t first = std::min(n, range.first * chunk);
+        size_t last = std::min(n, range.second * chunk);
+        memset(static_cast<void *>(ptr + first), 0, (last - first) * sizeof(T));
+    });
+    return ptr;
+}
+
+#endif // PARALLEL_H
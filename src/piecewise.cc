@@ -0,0 +1,147 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <math.h>
+#include <quadmath.h>
+#include <string>
+#include <vector>
+
+#include "erf.h"
+#include "piecewise.h"
+#include "reference.h"
+#include "remez.h"
+#include "util.h"
+
+// Generate the table of a piecewise polynomial (see piecewise.h):
+//
+//   piecewise [options] function lo hi
+//     --segments n         The number of segments, the default is 16.
+//     --degree d           The degree of the polynomials, the default is 5.
+//     --metric abs|rel|ulp The error metric, the default is rel.
+//     --type float|double  The type of the coefficients, the default is float.
+//     --name name          The name of the table, the default is table.
+//     --header path        Write the table to a header, and not to stdout.
+//
+// The functions are the __float128 functions of remez.h. Without arguments,
+// the program checks the evaluator, and verifies and benchmarks my_erf of
+// erf.h, the kernel on the generated erf_table.
+
+/// @return the description of the fit \p r of \p fn, for the comment of the
+/// table.
+std::string describe(const std::string &fn, const RemezProblem &p, const PiecewiseResult &r) {
+    char buffer[256];
+    double err = double(r.error);
+    snprintf(buffer, sizeof(buffer),
+             "%s on [%g .. %g], %zu segments of degree %d, %s error %.3g (2^%.1f)", fn.c_str(),
+             double(p.lo), double(p.hi), r.segments.size(), p.degree, metric_name(p.metric), err,
+             std::log2(err));
+    return buffer;
+}
+
+void check() {
+    // The segments of a polynomial are polynomials, which fit exactly.
+    RemezProblem cube = { [](__float128 x) { return x * x * x - x; }, -2, 2, 0, 3,
+                          ErrorMetric::Absolute, 53 };
+    PiecewiseResult r = fit_piecewise(cube, 4);
+    assert(r.lo == -2 && r.scale == 1 && r.error < 1e-30Q);
+    PiecewisePoly<double, 4, 4> table = { double(r.lo), double(r.scale), {} };
+    for (unsigned i = 0; i < 4; i++) {
+        for (unsigned k = 0; k < 4; k++) {
+            table.coeffs[i][k] = double(r.segments[i].coeffs[k]);
+        }
+    }
+    for (double x : { -2., -1.5, -1., 0., 0.25, 1., 1.75, 2. }) {
+        assert(eval_piecewise(table, x) == x * x * x - x);
+        assert(eval_piecewise<PolyScheme::Estrin>(table, x) == x * x * x - x);
+    }
+    // The inputs outside of the interval, and NaN, clamp to the ends.
+    assert(eval_piecewise(table, -3.) == -6 && eval_piecewise(table, double(-INFINITY)) == -6);
+    assert(eval_piecewise(table, 5.) == 6 && eval_piecewise(table, double(INFINITY)) == 6);
+    assert(eval_piecewise(table, double(NAN)) == -6);
+
+    // The segments that start at a zero fit from the power 1.
+    RemezProblem erf_rel = { erfq, 0, 4, 0, 3, ErrorMetric::Relative, 24 };
+    r = fit_piecewise(erf_rel, 4);
+    assert(r.scale == 1 && r.segments[0].coeffs[0] == 0 && r.segments[1].coeffs[0] != 0);
+
+    // The special values of my_erf, and the symmetry.
+    assert(same_bits(my_erf(0.f), 0.f) && same_bits(my_erf(-0.f), -0.f));
+    assert(my_erf(float(INFINITY)) == 1 && my_erf(float(-INFINITY)) == -1);
+    assert(my_erf(10.f) == 1 && my_erf(-10.f) == -1 && std::isnan(my_erf(float(NAN))));
+    assert(std::abs(my_erf(1e-30f) / 1e-30f - 1.1283791f) < 1e-6f);
+    std::vector<float> in = generate_test_vector<float>(-5, 5, 10000);
+    for (float x : { 0.f, -0.f, 1e-45f, -1e-45f, 4.f, 1e38f, float(INFINITY), float(-INFINITY),
+                     float(NAN) }) {
+        in.push_back(x);
+    }
+    std::vector<float> out(in.size());
+    my_erf(in.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); i++) {
+        assert(same_bits(out[i], my_erf(in[i])));
+        assert(same_bits(my_erf(-in[i]), -my_erf(in[i])) || std::isnan(in[i]));
+    }
+}
+
+// The libm kernel.
+float libm_erff(float x) { return erff(x); }
+
+void __attribute__((noinline)) libm_erff(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = erff(in[i]);
+    }
+}
+
+/// Verify and benchmark my_erf.
+void verify_erf() {
+    // The positive floats; my_erf is odd, so this covers the negative floats
+    // too. The reference is __float128, so these are samples.
+    Verifier<float, unsigned, 64, 16> v1, v2, v3;
+    printf("\nmy_erf, positive:");
+    v1.print_ulp_errors(my_erf, reference_erf<float>, 0, 0x7f800000, 1 << 22);
+    printf("\nmy_erf, [0 .. 4]:");
+    v2.print_ulp_errors(my_erf, reference_erf<float>, 0, 0x40800000, 1 << 22);
+    printf("\nlibm erff, [0 .. 4]:");
+    v3.print_ulp_errors(libm_erff, reference_erf<float>, 0, 0x40800000, 1 << 22);
+
+    std::vector<float> iv = generate_test_vector<float>(-4, 4, 10000);
+    bench_throughput("my_erf   ", my_erf, iv, 1000);
+    bench_throughput("libm_erff", libm_erff, iv, 1000);
+    bench_batch("batch_my_erf   ", my_erf, iv, 1000);
+    bench_batch("batch_libm_erff", libm_erff, iv, 1000);
+}
+
+int usage() {
+    fprintf(stderr, "usage: piecewise [--segments n] [--degree d] [--metric abs|rel|ulp]\n"
+                    "                 [--type float|double] [--name name] [--header path]\n"
+                    "                 function lo hi\n");
+    print_function_names(stderr);
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    check();
+    if (argc == 1) {
+        verify_erf();
+        return 0;
+    }
+
+    RemezProblem p;
+    p.degree = 5;
+    p.digits = 24;
+    int segments = 16;
+    GeneratorArgs g;
+    g.name = "table";
+    if (!parse_generator_args(argc, argv, p, g,
+                              { { "--segments", &segments }, { "--degree", &p.degree } }) ||
+        g.args.size() != 3 || !parse_function_and_interval(g.args, p) || p.degree < 0 ||
+        segments < 1) {
+        return usage();
+    }
+
+    PiecewiseResult r = fit_piecewise(p, segments);
+    std::string comment = describe(g.args[0], p, r);
+    return emit_table(g, "piecewise", "#include \"piecewise.h\"\n\n", comment,
+                      [&](FILE *out) { print_piecewise(out, g.name, p, r, comment); });
+}
@@ -0,0 +1,65 @@
+#ifndef PIECEWISE_H
+#define PIECEWISE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "poly.h"
+#include "util.h"
+
+// A piecewise polynomial: the pattern of my_log and my_exp, a table indexed
+// by a few bits of the input and a short polynomial on the residual, for any
+// smooth function on an interval. The interval [lo .. hi] is cut into
+// Segments equal segments, and the segment i is a polynomial of degree
+// Coeffs - 1 in t = (x - lo) * scale - i, in [0 .. 1]. The generator
+// piecewise.cc fits the tables with the Remez algorithm of remez.h, and prints
+// them as an inline constexpr PiecewisePoly.
+//
+// The evaluator has no branches: the index is a conversion of the scaled
+// input to an integer, and the coefficients are loads from the table, so a
+// loop over the evaluator vectorizes with gathers. When scale is a power of
+// two, t is exact for lo = 0, and the segments meet at the table boundaries.
+
+template <class T, size_t Segments, size_t Coeffs> struct PiecewisePoly {
+    // The start of the interval, and the number of segments per unit.
+    T lo, scale;
+    // The coefficients c0 .. c_degree of each segment.
+    T coeffs[Segments][Coeffs];
+};
+
+/// @return the piecewise polynomial \p p at \p x. The inputs below lo
+/// evaluate at lo, the inputs above the end of the last segment evaluate at
+/// the end, and NaN evaluates at lo.
+template <PolyScheme Scheme = PolyScheme::Horner, class T, size_t Segments, size_t Coeffs>
+inline T eval_piecewise(const PiecewisePoly<T, Segments, Coeffs> &p, T x) {
+    // The integer masks of blend keep the clamps free of branches, which
+    // std::min and std::max on floats are not. The comparison is false for
+    // NaN, which selects 0.
+    using Mask = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+    T u = (x - p.lo) * p.scale;
+    u = blend(-Mask(!(u >= 0)), T(0), u);
+    u = blend(-Mask(u > T(Segments)), T(Segments), u);
+    int32_t segment = std::min(int32_t(u), int32_t(Segments - 1));
+    T t = u - T(segment);
+    // Load the coefficients with the index, and not through a pointer to the
+    // row, which keeps GCC from vectorizing the loads into gathers.
+    size_t index = segment;
+    T c[Coeffs];
+    for (size_t k = 0; k < Coeffs; k++) {
+        c[k] = p.coeffs[index][k];
+    }
+    return poly<Scheme>(t, c);
+}
+
+/// Compute \p out[i] = eval_piecewise(\p p, \p in[i]) for \p n elements.
+template <PolyScheme Scheme = PolyScheme::Horner, class T, size_t Segments, size_t Coeffs>
+inline void eval_piecewise(const PiecewisePoly<T, Segments, Coeffs> &p, const T *in, T *out,
+                           size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = eval_piecewise<Scheme>(p, in[i]);
+    }
+}
+
+#endif // PIECEWISE_H
@@ -0,0 +1,70 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "exp_accurate.h"
+#include "log_accurate.h"
+#include "poly.h"
+#include "util.h"
+
+void check() {
+    // Integer coefficients and inputs are exact in all the schemes.
+    for (double x : { -3., -1., 0., 1., 2., 5. }) {
+        double expected = 1 + x * (2 + x * (3 + x * (4 + x * (5 + x * (6 + x * 7)))));
+        assert(horner(x, 1., 2., 3., 4., 5., 6., 7.) == expected);
+        assert(estrin(x, 1., 2., 3., 4., 5., 6., 7.) == expected);
+        assert(even_odd(x, 1., 2., 3., 4., 5., 6., 7.) == expected);
+    }
+    // All the degrees, and all the split points of Estrin's scheme.
+    assert(estrin(2., 1.) == 1);
+    assert(estrin(2., 1., 1.) == 3);
+    assert(estrin(2., 1., 1., 1.) == 7);
+    assert(estrin(2., 1., 1., 1., 1.) == 15);
+    assert(estrin(2., 1., 1., 1., 1., 1.) == 31);
+    assert(estrin(2., 1., 1., 1., 1., 1., 1., 1., 1., 1.) == 511);
+    assert(even_odd(2., 1.) == 1);
+    assert(even_odd(2., 1., 1.) == 3);
+    assert(even_odd(2., 1., 1., 1.) == 7);
+    assert(even_odd(2.f, 1.f, 1.f, 1.f, 1.f, 1.f) == 31);
+
+    // The schemes round differently, but agree to a few ULPs on the kernels.
+    std::vector<double> iv = generate_test_vector<double>(0, 0.0101, 10000);
+    for (double x : iv) {
+        double h = approximate_log_pol_1_to_1001<PolyScheme::Horner>(x);
+        assert(std::abs(h - approximate_log_pol_1_to_1001<PolyScheme::Estrin>(x)) <= 1e-15 * h);
+        assert(std::abs(h - approximate_log_pol_1_to_1001<PolyScheme::EvenOdd>(x)) <= 1e-15 * h);
+        double e = approximate_exp_pol_around_zero<PolyScheme::Horner>(x - 0.005);
+        assert(std::abs(e - approximate_exp_pol_around_zero<PolyScheme::Estrin>(x - 0.005)) <= 1e-15);
+        assert(std::abs(e - approximate_exp_pol_around_zero<PolyScheme::EvenOdd>(x - 0.005)) <= 1e-15);
+    }
+}
+
+/// Compare the latency and the throughput of the three schemes on one
+/// polynomial.
+template <double (*Horner)(double), double (*Estrin)(double), double (*EvenOdd)(double)>
+void bench_schemes(const std::string &name, const std::vector<double> &iv) {
+    bench_latency(name + "_horner_latency  ", Horner, iv);
+    bench_latency(name + "_estrin_latency  ", Estrin, iv);
+    bench_latency(name + "_even_odd_latency", EvenOdd, iv);
+    bench_throughput(name + "_horner_throughput  ", Horner, iv);
+    bench_throughput(name + "_estrin_throughput  ", Estrin, iv);
+    bench_throughput(name + "_even_odd_throughput", EvenOdd, iv);
+}
+
+int main(int argc, char **argv) {
+    check();
+
+    std::vector<double> log_iv = generate_test_vector<double>(0, 0.0101, 10000);
+    bench_schemes<approximate_log_pol_1_to_1001<PolyScheme::Horner>,
+                  approximate_log_pol_1_to_1001<PolyScheme::Estrin>,
+                  approximate_log_pol_1_to_1001<PolyScheme::EvenOdd>>("log_pol", log_iv);
+    std::vector<double> exp_iv = generate_test_vector<double>(-0.0039, 0.0039, 10000);
+    bench_schemes<approximate_exp_pol_around_zero<PolyScheme::Horner>,
+                  approximate_exp_pol_around_zero<PolyScheme::Estrin>,
+                  approximate_exp_pol_around_zero<PolyScheme::EvenOdd>>("exp_pol", exp_iv);
+    return 0;
+}
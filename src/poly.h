@@ -0,0 +1,109 @@
+#ifndef POLY_H
+#define POLY_H
+
+#include <cmath>
+#include <cstddef>
+
+// Polynomial evaluation with the coefficients as an array, in the order
+// c0, c1, ... cn of c0 + c1*x + ... + cn*x^n, like the tables that remez.cc
+// generates, or as a parameter pack in the same order. The degree is known at
+// compile time, so the evaluators unroll completely, and every step is an
+// explicit fma, so the rounding does not depend on the contraction flags of
+// the compiler.
+
+/// The evaluation schemes:
+/// Horner - The shortest chain of operations, but each step depends on the
+///          previous one, so the latency is n fma operations.
+/// Estrin - Evaluates pairs of coefficients with independent fma operations,
+///          and combines them with x^2, x^4, ..., so the latency is about
+///          log2(n) steps, at the price of computing the powers of x.
+/// EvenOdd - Two independent Horner chains in x^2 for the even and the odd
+///          coefficients, which halves the latency of Horner.
+/// Horner is usually the fastest when the loop is limited by throughput, and
+/// the other schemes win when a single evaluation is on the critical path.
+enum class PolyScheme { Horner, Estrin, EvenOdd };
+
+namespace detail {
+
+/// Evaluate the \p N coefficients c[Lo], c[Lo + Stride], ... with Horner's
+/// method.
+template <size_t Lo, size_t N, size_t Stride, class T> inline T horner_range(const T *c, T x) {
+    if constexpr (N == 1) {
+        return c[Lo];
+    } else {
+        return std::fma(x, horner_range<Lo + Stride, N - 1, Stride>(c, x), c[Lo]);
+    }
+}
+
+/// @return the number of squarings that Estrin's scheme needs for a
+/// polynomial with \p n coefficients.
+constexpr size_t estrin_levels(size_t n) {
+    size_t levels = 0;
+    for (size_t p = 1; p < n; p *= 2) {
+        levels++;
+    }
+    return levels;
+}
+
+/// Evaluate the \p N coefficients of \p c that start at \p Lo. The polynomial
+/// is split into a lower part of 2^k coefficients and the rest, which is
+/// multiplied by pows[k] = x^(2^k).
+template <size_t Lo, size_t N, class T> inline T estrin_range(const T *c, const T *pows) {
+    if constexpr (N == 1) {
+        return c[Lo];
+    } else {
+        constexpr size_t k = estrin_levels(N) - 1;
+        constexpr size_t half = size_t(1) << k;
+        T lo = estrin_range<Lo, half>(c, pows);
+        T hi = estrin_range<Lo + half, N - half>(c, pows);
+        return std::fma(pows[k], hi, lo);
+    }
+}
+
+} // namespace detail
+
+/// Evaluate the polynomial with the \p n coefficients \p c, in the order c0,
+/// c1, ..., with the scheme \p Scheme. This is the form of the coefficient
+/// tables that remez.cc generates.
+template <PolyScheme Scheme, class T, size_t n> inline T poly(T x, const T (&c)[n]) {
+    if constexpr (Scheme == PolyScheme::Horner || n == 1) {
+        return detail::horner_range<0, n, 1>(c, x);
+    } else if constexpr (Scheme == PolyScheme::EvenOdd) {
+        T x2 = x * x;
+        T even = detail::horner_range<0, (n + 1) / 2, 2>(c, x2);
+        T odd = detail::horner_range<1, n / 2, 2>(c, x2);
+        return std::fma(x, odd, even);
+    } else {
+        // The powers x, x^2, x^4, ... that combine the levels.
+        constexpr size_t levels = detail::estrin_levels(n);
+        T pows[levels];
+        pows[0] = x;
+        for (size_t i = 1; i < levels; i++) {
+            pows[i] = pows[i - 1] * pows[i - 1];
+        }
+        return detail::estrin_range<0, n>(c, pows);
+    }
+}
+
+/// Evaluate the polynomial c0 + c1*x + ... with the scheme \p Scheme.
+template <PolyScheme Scheme, class T, class... Cs> inline T poly(T x, T c0, Cs... cs) {
+    const T c[1 + sizeof...(Cs)] = { c0, T(cs)... };
+    return poly<Scheme>(x, c);
+}
+
+/// Evaluate the polynomial c0 + c1*x + ... with Horner's method.
+template <class T, class... Cs> inline T horner(T x, T c0, Cs... cs) {
+    return poly<PolyScheme::Horner, T>(x, c0, T(cs)...);
+}
+
+/// Evaluate the polynomial c0 + c1*x + ... with Estrin's scheme.
+template <class T, class... Cs> inline T estrin(T x, T c0, Cs... cs) {
+    return poly<PolyScheme::Estrin, T>(x, c0, T(cs)...);
+}
+
+/// Evaluate the polynomial c0 + c1*x + ... as even(x^2) + x * odd(x^2).
+template <class T, class... Cs> inline T even_odd(T x, T c0, Cs... cs) {
+    return poly<PolyScheme::EvenOdd, T>(x, c0, T(cs)...);
+}
+
+#endif // POLY_H
@@ -0,0 +1,176 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "exp_accurate.h"
+#include "quant.h"
+#include "util.h"
+
+// The scales of typical int8 activations, and some odd ones.
+static const float scales[] = { 1.f / 16, 1.f / 32, 0.0127f, 0.05f, 0.1f, 0.2f, 0.39f };
+static const int zero_points[] = { -128, -17, 0, 5, 127 };
+
+void check() {
+    // The tables are built with my_exp, so the lookups are bit exact.
+    for (float scale : scales) {
+        for (int zp : zero_points) {
+            const QuantTable &table = QuantTableCache::get(QuantFn::Exp, scale, zp);
+            for (int q = -128; q < 128; q++) {
+                float expected = my_exp(scale * float(q - zp));
+                assert(table[int8_t(q)] == expected);
+            }
+        }
+    }
+
+    // Tables are cached by scale and zero point.
+    QuantTableCache &cache = QuantTableCache::instance();
+    size_t size = cache.size();
+    assert(&QuantTableCache::get(QuantFn::Exp, 0.1f, 0) == &QuantTableCache::get(QuantFn::Exp, 0.1f, 0));
+    assert(&QuantTableCache::get(QuantFn::Exp, 0.1f, 0) != &QuantTableCache::get(QuantFn::Exp, 0.1f, 1));
+    assert(cache.size() == size + 1);
+    // The softmax tables ignore the zero point.
+    assert(&QuantTableCache::get(QuantFn::Softmax, 0.1f, 3) == &QuantTableCache::get(QuantFn::Softmax, 0.1f, 9));
+
+    // The batch kernels.
+    int8_t in[256];
+    float out[256];
+    for (int i = 0; i < 256; i++) {
+        in[i] = int8_t(i - 128);
+    }
+    quant_exp(in, out, 256, 0.05f, 3);
+    for (int i = 0; i < 256; i++) {
+        assert(out[i] == my_exp(0.05f * float(in[i] - 3)));
+    }
+    quant_sigmoid(in, out, 256, 0.1f, 0);
+    assert(out[128] == 0.5f);
+    for (int i = 1; i < 256; i++) {
+        assert(out[i] > out[i - 1]);
+        assert(std::abs(out[i] - 1 / (1 + std::exp(-0.1 * in[i]))) < 1e-7);
+    }
+
+    // Softmax sums to one, and is shift invariant in the integer domain.
+    float shifted[256];
+    for (int i = 0; i < 256; i++) {
+        in[i] = int8_t(i / 2 - 128);
+    }
+    quant_softmax(in, out, 256, 0.05f);
+    for (int i = 0; i < 256; i++) {
+        in[i] = int8_t(i / 2 - 64);
+    }
+    quant_softmax(in, shifted, 256, 0.05f);
+    double sum = 0;
+    for (int i = 0; i < 256; i++) {
+        sum += out[i];
+        assert(out[i] == shifted[i]);
+    }
+    assert(std::abs(sum - 1) < 1e-6);
+    // A single element.
+    quant_softmax(in, out, 1, 0.05f);
+    assert(out[0] == 1);
+}
+
+/// Compare the sigmoid tables to the double precision result on all the
+/// inputs of many scales and zero points.
+void print_sigmoid_ulp_deltas() {
+    Histogram<4> hist;
+    uint64_t total = 0;
+    for (float scale = 0.001f; scale < 1; scale *= 1.01f) {
+        for (int zp = -128; zp < 128; zp += 17) {
+            const QuantTable &table = QuantTableCache::get(QuantFn::Sigmoid, scale, zp);
+            for (int q = -128; q < 128; q++) {
+                double x = double(scale * float(q - zp));
+                float expected = 1 / (1 + std::exp(-x));
+                hist.add(ulp_difference<unsigned, float>(table[int8_t(q)], expected));
+                total++;
+            }
+        }
+    }
+    hist.dump("\nULP delta (sigmoid):\n", total);
+}
+
+// Dequantize and call my_exp, which is what the callers do today.
+void __attribute__((noinline)) dequant_exp(const int8_t *in, float *out, size_t n, float scale,
+                                           int zero_point) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = my_exp(scale * float(in[i] - zero_point));
+    }
+}
+
+void __attribute__((noinline)) dequant_softmax(const int8_t *in, float *out, size_t n,
+                                               float scale) {
+    int max = -128;
+    for (size_t i = 0; i < n; i++) {
+        max = std::max<int>(max, in[i]);
+    }
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = my_exp(scale * float(in[i] - max));
+        sum += out[i];
+    }
+    float inv = float(1 / sum);
+    for (size_t i = 0; i < n; i++) {
+        out[i] *= inv;
+    }
+}
+
+void exp_quant_cached(const int8_t *in, float *out, size_t n, float scale, int zero_point) {
+    quant_exp(in, out, n, scale, zero_point);
+}
+void exp_quant_table(const int8_t *in, float *out, size_t n, float scale, int zero_point) {
+    static const QuantTable &table = QuantTableCache::get(QuantFn::Exp, scale, zero_point);
+    quant_lookup(table, in, out, n);
+}
+void softmax_quant(const int8_t *in, float *out, size_t n, float scale, int zero_point) {
+    quant_softmax(in, out, n, scale);
+}
+void softmax_dequant(const int8_t *in, float *out, size_t n, float scale, int zero_point) {
+    dequant_softmax(in, out, n, scale);
+}
+void exp_dequant(const int8_t *in, float *out, size_t n, float scale, int zero_point) {
+    dequant_exp(in, out, n, scale, zero_point);
+}
+
+/// Benchmark \p handle on rows of \p row int8 values, which is the length of
+/// the attention rows for softmax.
+void bench_quant(const std::string &name,
+                 void (*handle)(const int8_t *, float *, size_t, float, int), size_t row) {
+    const size_t n = 1 << 20;
+    std::vector<int8_t> in(n);
+    std::vector<float> out(n);
+    std::vector<float> fv = generate_test_vector<float>(-128, 127, n);
+    for (size_t i = 0; i < n; i++) {
+        in[i] = int8_t(fv[i]);
+    }
+
+    auto t1 = high_resolution_clock::now();
+    double sum = 0;
+    for (int iter = 0; iter < 64; iter++) {
+        for (size_t i = 0; i + row <= n; i += row) {
+            handle(in.data() + i, out.data() + i, row, 0.05f, 3);
+        }
+        sum += out[iter];
+    }
+    auto t2 = high_resolution_clock::now();
+    double ns = duration_cast<duration<double, std::nano>>(t2 - t1).count();
+    printf("name = %-16s, row = %5zu, sum = %g, time = %.2fns/elem\n", name.c_str(), row, sum,
+           ns / double(64 * n));
+}
+
+int main(int argc, char **argv) {
+    check();
+    print_sigmoid_ulp_deltas();
+
+    for (size_t row : { 64, 1024, 1 << 20 }) {
+        printf("\n");
+        bench_quant("exp_dequant", exp_dequant, row);
+        bench_quant("exp_quant_cached", exp_quant_cached, row);
+        bench_quant("exp_quant_table", exp_quant_table, row);
+        bench_quant("softmax_dequant", softmax_dequant, row);
+        bench_quant("softmax_quant", softmax_quant, row);
+    }
+    return 0;
+}
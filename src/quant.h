@@ -0,0 +1,133 @@
+#ifndef QUANT_H
+#define QUANT_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include "exp_accurate.h"
+#include "util.h"
+
+// The int8 tensors of quantized inference represent the real value
+// scale * (q - zero_point). There are only 256 distinct inputs per scale and
+// zero point, so exp and sigmoid are computed once per input into a table,
+// and the batch kernels only index the table with the input byte.
+
+/// Selects the function of a QuantTable.
+enum class QuantFn {
+    Exp,     // exp(scale * (q - zero_point))
+    Sigmoid, // 1 / (1 + exp(-scale * (q - zero_point)))
+    Softmax, // exp(-scale * d) for the distance d = max - q in [0 .. 255]
+};
+
+/// The results of one function for all the 256 inputs of a quantization
+/// scale and zero point. The table is indexed by the byte of the input,
+/// which places the negative inputs at the upper half.
+struct QuantTable {
+    float data_[256];
+
+    QuantTable(QuantFn fn, float scale, int zero_point) {
+        for (int i = 0; i < 256; i++) {
+            int q = int8_t(uint8_t(i));
+            float x = scale * float(q - zero_point);
+            if (fn == QuantFn::Exp) {
+                data_[i] = my_exp(x);
+            } else if (fn == QuantFn::Sigmoid) {
+                // Use exp(x) for negative inputs, where exp(-x) overflows
+                // before the sigmoid underflows.
+                double e = my_exp(-std::abs(x));
+                data_[i] = x >= 0 ? 1 / (1 + e) : e / (1 + e);
+            } else {
+                data_[i] = my_exp(-scale * float(i));
+            }
+        }
+    }
+
+    float operator[](int8_t q) const { return data_[uint8_t(q)]; }
+};
+
+/// A process-wide cache of the tables, keyed by the function, the bits of the
+/// scale and the zero point. Tensors usually share a handful of scales, so
+/// the tables are built once and never evicted. The references that get()
+/// returns stay valid for the lifetime of the program.
+class QuantTableCache {
+    std::mutex lock_;
+    std::map<std::tuple<QuantFn, uint32_t, int>, QuantTable> tables_;
+
+  public:
+    static QuantTableCache &instance() {
+        static QuantTableCache cache;
+        return cache;
+    }
+
+    const QuantTable &lookup(QuantFn fn, float scale, int zero_point) {
+        // The softmax tables depend only on the scale.
+        zero_point = (fn == QuantFn::Softmax) ? 0 : zero_point;
+        auto key = std::make_tuple(fn, bit_cast<uint32_t, float>(scale), zero_point);
+        std::lock_guard<std::mutex> guard(lock_);
+        auto it = tables_.find(key);
+        if (it == tables_.end()) {
+            it = tables_.emplace(key, QuantTable(fn, scale, zero_point)).first;
+        }
+        return it->second;
+    }
+
+    static const QuantTable &get(QuantFn fn, float scale, int zero_point) {
+        return instance().lookup(fn, scale, zero_point);
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> guard(lock_);
+        return tables_.size();
+    }
+};
+
+/// Apply the function of \p table to the \p n int8 values in \p in.
+KERNEL_API void quant_lookup(const QuantTable &table, const int8_t *in, float *out,
+                             size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = table[in[i]];
+    }
+}
+
+/// Compute exp(scale * (in[i] - zero_point)) for the \p n values in \p in.
+inline void quant_exp(const int8_t *in, float *out, size_t n, float scale, int zero_point) {
+    quant_lookup(QuantTableCache::get(QuantFn::Exp, scale, zero_point), in, out, n);
+}
+
+/// Compute the sigmoid of scale * (in[i] - zero_point) for the \p n values in
+/// \p in.
+inline void quant_sigmoid(const int8_t *in, float *out, size_t n, float scale, int zero_point) {
+    quant_lookup(QuantTableCache::get(QuantFn::Sigmoid, scale, zero_point), in, out, n);
+}
+
+/// Compute the softmax of the \p n quantized values in \p in. The maximum is
+/// subtracted in the integer domain, where the zero point cancels out, so the
+/// distance max - q indexes a table of exp(-scale * d) that depends only on
+/// the scale, and the largest term of the sum is exactly one.
+KERNEL_API void quant_softmax(const int8_t *in, float *out, size_t n, float scale) {
+    if (n == 0) {
+        return;
+    }
+    const float *table = QuantTableCache::get(QuantFn::Softmax, scale, 0).data_;
+
+    int max = -128;
+    for (size_t i = 0; i < n; i++) {
+        max = std::max<int>(max, in[i]);
+    }
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        float e = table[max - in[i]];
+        out[i] = e;
+        sum += e;
+    }
+    float inv = float(1 / sum);
+    for (size_t i = 0; i < n; i++) {
+        out[i] *= inv;
+    }
+}
+
+#endif // QUANT_H
@@ -0,0 +1,121 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <math.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "exp_accurate.h"
+#include "log_accurate.h"
+#include "logaddexp.h"
+#include "reference.h"
+#include "util.h"
+
+void check() {
+    assert(ulp_error(1., { 1, 0 }) == 0);
+    assert(ulp_error(1 + 0x1p-52, { 1, 0 }) == 1);
+    assert(ulp_error(1.f, { 1, 0x1p-25 }) == 0.25);
+    assert(ulp_error(0x1p-1074, { 0, 0 }) == 1);
+    assert(ulp_error(0x1p-149f, { 0x1p-150, 0 }) == 0.5);
+    assert(ulp_error(double(NAN), { NAN, 0 }) == 0);
+    assert(ulp_error(double(INFINITY), { INFINITY, 0 }) == 0);
+    assert(ulp_error(1e308, { INFINITY, 0 }) == INFINITY);
+
+    // The double-double log agrees with __float128 on all the exponents.
+    std::mt19937_64 mt(42);
+    std::vector<double> in(100000);
+    for (double &x : in) {
+        x = bit_cast<double, uint64_t>(mt() % 0x7ff0000000000000);
+    }
+    in.push_back(0);
+    in.push_back(-1);
+    in.push_back(INFINITY);
+    std::vector<DoubleDouble> fast(in.size()), quad(in.size());
+    reference_log(in.data(), fast.data(), in.size());
+    reference_log_quad(in.data(), quad.data(), in.size());
+    for (size_t i = 0; i < in.size(); i++) {
+        assert(ulp_error(quad[i].hi, fast[i]) <= 0.5 + 0x1p-40);
+    }
+}
+
+// The double kernels that are measured with the reference.
+double libm_log(double x) { return log(x); }
+double libm_exp(double x) { return exp(x); }
+double log_positive_double(double x) { return log_positive(x); }
+double exp_neg_reduced_double(double x) { return exp_neg_reduced(-x); }
+
+/// Benchmark the batch reference \p ref on the inputs \p iv.
+void bench_reference(const std::string &name,
+                     void (*ref)(const double *, DoubleDouble *, size_t),
+                     const std::vector<double> &iv, int iterations) {
+    std::vector<DoubleDouble> out(iv.size());
+    auto t1 = high_resolution_clock::now();
+    double sum = 0;
+    for (int iter = 0; iter < iterations; iter++) {
+        ref(iv.data(), out.data(), iv.size());
+        sum += out[iter % out.size()].hi;
+    }
+    auto t2 = high_resolution_clock::now();
+    std::cout << "name = " << name << ", sum = " << sum << ", time = "
+              << duration_cast<milliseconds>(t2 - t1).count() << "ms\n";
+}
+
+/// Sample the double kernel \p handle against \p ref on \p count bit
+/// patterns in [first .. last). With a \p checkpoint prefix, the run saves
+/// its state to the file prefix.name, and resumes from it.
+/// @return False if the run was interrupted.
+bool sample_double(const std::string &name, double (*handle)(double),
+                   void (*ref)(const double *, DoubleDouble *, size_t), uint64_t first,
+                   uint64_t last, uint64_t count, const std::string &checkpoint) {
+    Verifier<double, uint64_t, 64, 16> verifier;
+    if (!checkpoint.empty()) {
+        verifier.set_checkpoint(checkpoint + "." + name);
+    }
+    printf("\n%s:", name.c_str());
+    verifier.print_ulp_errors(handle, ref, first, last, count);
+    return !verifier.cancelled();
+}
+
+int main(int argc, char **argv) {
+    check();
+
+    // The samplings of the double kernels are long. With --checkpoint prefix,
+    // they save their state every minute and on SIGINT, and the next run with
+    // the same prefix resumes them.
+    std::string checkpoint = argc == 3 && std::string(argv[1]) == "--checkpoint" ? argv[2] : "";
+    cancel_verifiers_on_sigint();
+
+    // Random doubles of all the exponents, and exp in [-708 .. 709].
+    if (!sample_double("libm_log", libm_log, reference_log, 0, 0x7ff0000000000000, 1 << 26,
+                       checkpoint) ||
+        !sample_double("log_positive", log_positive_double, reference_log, 0x0010000000000000,
+                       0x7ff0000000000000, 1 << 26, checkpoint) ||
+        !sample_double("libm_exp", libm_exp, reference_exp, 0, 0x408625c000000000, 1 << 20,
+                       checkpoint) ||
+        !sample_double("exp_neg_reduced", exp_neg_reduced_double, reference_exp, 0,
+                       0x408625c000000000, 1 << 20, checkpoint)) {
+        printf("Interrupted.\n");
+        return 1;
+    }
+
+    // The float kernels, on a slice of the bit patterns around one.
+    Verifier<float, unsigned, 64, 16> verifier5;
+    printf("\nmy_log:");
+    verifier5.print_ulp_errors(my_log, reference_log, 0x3f000000, 0x40000000);
+    Verifier<float, unsigned, 64, 16> verifier6;
+    printf("\nmy_exp:");
+    verifier6.print_ulp_errors(my_exp, reference_exp, 0x3f000000, 0x3f800000);
+    if (verifier_interrupted) {
+        printf("Interrupted.\n");
+        return 1;
+    }
+
+    std::vector<double> iv = generate_test_vector<double>(0.01, 1000., 10000);
+    bench_reference("reference_log     ", reference_log, iv, 100);
+    bench_reference("reference_log_quad", reference_log_quad, iv, 100);
+    std::vector<double> ev = generate_test_vector<double>(-20., 20., 10000);
+    bench_reference("reference_exp     ", reference_exp, ev, 100);
+    return 0;
+}
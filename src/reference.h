@@ -0,0 +1,136 @@
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+#include <cmath>
+#include <cstddef>
+#include <quadmath.h>
+
+#include "double_double.h"
+#include "log_dd.h"
+#include "util.h"
+
+// Reference functions with more than 100 bits of precision, to measure the
+// error of the double kernels, where the libm double functions are not
+// accurate enough to be the ground truth. The results are double-double
+// values, so the error of a kernel can be measured in fractions of an ULP
+// with ulp_error(). The batch interface matches Verifier::print_ulp_errors.
+//
+// The log reference is the double-double kernel of log_dd.h, which has a
+// relative error below 2^-100 and vectorizes, and is about 150x faster than
+// __float128. The exp reference is __float128, in the *_quad functions.
+
+/// @return \p x rounded to a double-double value.
+inline DoubleDouble to_double_double(__float128 x) {
+    double hi = double(x);
+    if (!std::isfinite(hi)) {
+        return { hi, 0 };
+    }
+    return { hi, double(x - hi) };
+}
+
+/// Compute the reference log of \p n elements with __float128.
+inline void __attribute__((noinline)) reference_log_quad(const double *in, DoubleDouble *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = to_double_double(logq(__float128(in[i])));
+    }
+}
+
+/// Compute the reference exp of \p n elements with __float128.
+inline void __attribute__((noinline)) reference_exp_quad(const double *in, DoubleDouble *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = to_double_double(expq(__float128(in[i])));
+    }
+}
+
+/// Compute the reference log of \p n elements.
+inline void __attribute__((noinline)) reference_log(const double *in, DoubleDouble *out, size_t n) {
+    // Like the batch my_log_dd: the first loop vectorizes, and the second one
+    // fixes the inputs that are not positive normal doubles.
+    for (size_t i = 0; i < n; i++) {
+        out[i] = log_dd_normal(in[i], 0);
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (!(in[i] >= 0x1p-1022 && in[i] <= 0x1.fffffffffffffp1023)) {
+            out[i] = log_dd_impl(in[i]);
+        }
+    }
+}
+
+/// Compute the reference exp of \p n elements.
+inline void __attribute__((noinline)) reference_exp(const double *in, DoubleDouble *out, size_t n) {
+    reference_exp_quad(in, out, n);
+}
+
+/// The references for the float kernels. The float inputs are exact doubles.
+inline void __attribute__((noinline)) reference_log(const float *in, DoubleDouble *out, size_t n) {
+    double buffer[1024];
+    for (size_t i = 0; i < n; i += 1024) {
+        size_t len = std::min<size_t>(1024, n - i);
+        for (size_t j = 0; j < len; j++) {
+            buffer[j] = in[i + j];
+        }
+        reference_log(buffer, out + i, len);
+    }
+}
+inline void __attribute__((noinline)) reference_exp(const float *in, DoubleDouble *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = to_double_double(expq(__float128(in[i])));
+    }
+}
+
+/// @return digamma(x) in __float128. The positive inputs are shifted up to 40
+/// with digamma(x) = digamma(x + 1) - 1/x, where the asymptotic series with 12
+/// terms is accurate to 2^-110, and the negative inputs go through the
+/// reflection formula.
+inline __float128 digamma_quad(__float128 x) {
+    if (x <= 0) {
+        if (x == floorq(x)) {
+            return x == 0 ? -copysignq(INFINITY, x) : __float128(NAN);
+        }
+        return digamma_quad(1 - x) - M_PIq / tanq(M_PIq * (x - nearbyintq(x)));
+    }
+    if (isinfq(x) || isnanq(x)) {
+        return x;
+    }
+    // B_2k / 2k.
+    static const __float128 coeffs[12] = {
+        1.Q / 12,           -1.Q / 120,          1.Q / 252,
+        -1.Q / 240,         1.Q / 132,           -691.Q / 32760,
+        1.Q / 12,           -3617.Q / 8160,      43867.Q / 14364,
+        -174611.Q / 6600,   77683.Q / 276,       -236364091.Q / 65520,
+    };
+    __float128 sum = 0;
+    while (x < 40) {
+        sum -= 1 / x;
+        x += 1;
+    }
+    __float128 r2 = 1 / (x * x), p = r2, series = 0;
+    for (int k = 0; k < 12; k++) {
+        series += coeffs[k] * p;
+        p *= r2;
+    }
+    return sum + logq(x) - 1 / (2 * x) - series;
+}
+
+/// Compute the reference lgamma, digamma and erf of \p n elements with
+/// __float128.
+template <class FloatTy>
+void __attribute__((noinline)) reference_lgamma(const FloatTy *in, DoubleDouble *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = to_double_double(lgammaq(__float128(in[i])));
+    }
+}
+template <class FloatTy>
+void __attribute__((noinline)) reference_digamma(const FloatTy *in, DoubleDouble *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = to_double_double(digamma_quad(__float128(in[i])));
+    }
+}
+template <class FloatTy>
+void __attribute__((noinline)) reference_erf(const FloatTy *in, DoubleDouble *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = to_double_double(erfq(__float128(in[i])));
+    }
+}
+
+#endif // REFERENCE_H
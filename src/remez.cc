@@ -0,0 +1,168 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <quadmath.h>
+#include <string>
+#include <vector>
+
+#include "exp_accurate.h"
+#include "exp_approx.h"
+#include "log_accurate.h"
+#include "log_approx.h"
+#include "remez.h"
+#include "util.h"
+
+// Generate the coefficients of a minimax polynomial (see remez.h):
+//
+//   remez [options] function lo hi degree
+//     --first k            The lowest power, the default is 0.
+//     --metric abs|rel|ulp The error metric, the default is rel.
+//     --type float|double  The type of the coefficients, the default is double.
+//     --name name          The name of the table, the default is coeffs.
+//     --header path        Write the table to a header, and not to stdout.
+//   remez --kernels
+//
+// The functions are the __float128 functions of remez.h. The table of
+// the coefficients is an inline constexpr array, which poly() evaluates. With
+// --kernels, the tool fits the polynomials of the kernels of the tree, and
+// compares them to the coefficients in the headers.
+
+__float128 log1p_quad(__float128 x) { return log1pq(x); }
+__float128 exp_quad(__float128 x) { return expq(x); }
+__float128 log2_quad(__float128 x) { return log2q(x); }
+
+/// @return the description of the fit \p p of \p fn, for the comment of the
+/// table.
+std::string describe(const std::string &fn, const RemezProblem &p, const RemezResult &r) {
+    char buffer[256];
+    double err = double(r.error);
+    snprintf(buffer, sizeof(buffer), "%s on [%g .. %g], degree %d, %s error %.3g (2^%.1f)%s",
+             fn.c_str(), double(p.lo), double(p.hi), p.degree, metric_name(p.metric), err,
+             std::log2(err), r.converged ? "" : ", not converged");
+    return buffer;
+}
+
+/// @return the max error of the coefficients \p c of a kernel on \p p.
+__float128 kernel_error(const RemezProblem &p, std::vector<__float128> c) {
+    __float128 err = 0;
+    for (const detail::Extremum &e : detail::find_extrema(p, c, 4097)) {
+        err = fmaxq(err, fabsq(e.err));
+    }
+    return err;
+}
+
+/// Fit the polynomial \p p of the kernel \p name, and compare it to the
+/// table \p current of the kernel in the tree.
+template <size_t N>
+void fit_kernel(const char *name, const char *fn, const RemezProblem &p,
+                const double (&current)[N]) {
+    RemezResult r = fpminimax(p);
+    std::vector<__float128> c(current, current + N);
+    printf("\n%s: in the tree %.3g, generated %.3g\n", name, double(kernel_error(p, c)),
+           double(r.error));
+    print_coefficients(stdout, name + std::string("_coeffs"), p, r, describe(fn, p, r));
+}
+
+/// Fit the polynomials of the kernels, with the arguments of log.sollya and
+/// exp.sollya, and on the reduced ranges of fastlog2 and fast_exp.
+void fit_kernels() {
+    // The reduced argument z of my_log is in [0 .. 0.0101]. log1p(z) has a
+    // zero at z = 0, so the fit starts at the power 1.
+    RemezProblem log_pol = { log1p_quad, 0, 0.0101Q, 1, 5, ErrorMetric::Relative, 53 };
+    fit_kernel("log1p_pol", "log1p", log_pol, log1p_pol_coeffs);
+
+    RemezProblem exp_pol = { exp_quad, -0.0039Q, 0.0039Q, 0, 5, ErrorMetric::Relative, 53 };
+    fit_kernel("exp_pol", "exp", exp_pol, exp_pol_coeffs);
+
+    // The mantissa of my_frexp is in [0.5 .. 1), and fastlog2 adds the
+    // exponent to the polynomial, so the error is absolute.
+    RemezProblem log2_pol = { log2_quad, 0.5Q, 1, 0, 3, ErrorMetric::Absolute, 53 };
+    fit_kernel("fastlog2", "log2", log2_pol, fastlog2_coeffs);
+
+    // The fraction x - trunc(x) of fast_exp is in (-1 .. 1).
+    RemezProblem exp_frac = { exp_quad, -1, 1, 0, 3, ErrorMetric::Relative, 53 };
+    fit_kernel("fast_exp", "exp", exp_frac, fast_exp_coeffs);
+}
+
+void check() {
+    // The minimax line of x^2 on [0 .. 1] is x - 1/8, with the error 1/8.
+    RemezProblem square = { [](__float128 x) { return x * x; }, 0, 1, 0, 1,
+                            ErrorMetric::Absolute, 53 };
+    RemezResult r = minimax(square);
+    assert(r.converged && fabsq(r.error - 0.125Q) < 1e-20Q);
+    assert(fabsq(r.coeffs[0] + 0.125Q) < 1e-20Q && fabsq(r.coeffs[1] - 1) < 1e-20Q);
+
+    // x^3 - 3x/4 is T3/4, so the minimax quadratic of x^3 on [-1 .. 1] is
+    // 3x/4, with the error 1/4.
+    RemezProblem cube = { [](__float128 x) { return x * x * x; }, -1, 1, 0, 2,
+                          ErrorMetric::Absolute, 53 };
+    r = minimax(cube);
+    assert(r.converged && fabsq(r.error - 0.25Q) < 1e-20Q);
+    assert(fabsq(r.coeffs[1] - 0.75Q) < 1e-20Q && fabsq(r.coeffs[2]) < 1e-20Q);
+
+    // A polynomial fits itself exactly, with the coefficients in float.
+    RemezProblem self = { [](__float128 x) { return 1 + x * (0.5Q + x * 0.25Q); }, -2, 3, 0, 2,
+                          ErrorMetric::Relative, 24 };
+    r = fpminimax(self);
+    assert(r.converged && r.error < 1e-30Q && r.coeffs[0] == 1 && r.coeffs[1] == 0.5Q && r.coeffs[2] == 0.25Q);
+
+    // The rounded coefficients are floats. The ULP error of exp on
+    // [-0.5 .. 0.5] in degree 6 is 0.28 with the exact coefficients, and below
+    // 1 with the floats, where the rounding of c1 costs most of the difference.
+    RemezProblem exp_ulp = { exp_quad, -0.5Q, 0.5Q, 0, 6, ErrorMetric::ULP, 24 };
+    RemezResult exact = minimax(exp_ulp);
+    r = fpminimax(exp_ulp);
+    for (__float128 c : r.coeffs) {
+        assert(c == __float128(float(c)));
+    }
+    assert(exact.converged && exact.error < 0.3Q && r.error < 1);
+
+    // In double, the rounding of exp in degree 5 costs a few percent.
+    RemezProblem exp_rel = { exp_quad, -0.5Q, 0.5Q, 0, 5, ErrorMetric::Relative, 53 };
+    exact = minimax(exp_rel);
+    r = fpminimax(exp_rel);
+    assert(r.error < exact.error * 1.05Q);
+
+    // The fit starts at the first power.
+    RemezProblem log1p_pol = { log1p_quad, 0, 0.25Q, 1, 8, ErrorMetric::Relative, 53 };
+    r = fpminimax(log1p_pol);
+    assert(r.converged && r.coeffs[0] == 0 && r.error < 1e-10Q);
+
+    // The table evaluates with poly().
+    const double c[3] = { 1, 0.5, 0.25 };
+    assert(poly<PolyScheme::Estrin>(2., c) == 3 && poly<PolyScheme::EvenOdd>(2., c) == 3);
+}
+
+int usage() {
+    fprintf(stderr, "usage: remez [--first k] [--metric abs|rel|ulp] [--type float|double]\n"
+                    "             [--name name] [--header path] function lo hi degree\n"
+                    "       remez --kernels\n");
+    print_function_names(stderr);
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc == 2 && std::string(argv[1]) == "--kernels") {
+        check();
+        fit_kernels();
+        return 0;
+    }
+    RemezProblem p;
+    GeneratorArgs g;
+    g.name = "coeffs";
+    if (!parse_generator_args(argc, argv, p, g, { { "--first", &p.first } }) ||
+        g.args.size() != 4 || !parse_function_and_interval(g.args, p)) {
+        return usage();
+    }
+    p.degree = atoi(g.args[3].c_str());
+    if (p.degree < 0 || p.first < 0 || p.first > p.degree) {
+        return usage();
+    }
+    check();
+
+    RemezResult r = fpminimax(p);
+    std::string comment = describe(g.args[0], p, r);
+    return emit_table(g, "remez", "", comment,
+                      [&](FILE *out) { print_coefficients(out, g.name, p, r, comment); });
+}
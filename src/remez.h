@@ -0,0 +1,606 @@
+#ifndef REMEZ_H
+#define REMEZ_H
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <quadmath.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A minimax polynomial generator, in __float128, in place of the fpminimax
+// command of Sollya and the curve_fit of scipy. The Remez exchange algorithm
+// finds the polynomial c_first * x^first + ... + c_degree * x^degree with the
+// smallest max error to a function on an interval, where the error is
+// absolute, relative, or in ULPs of the result. The coefficients are then
+// rounded to float or double one at a time, from the highest power down, and
+// the lower coefficients are fitted again after each rounding, so they absorb
+// the rounding error of the higher ones. The lower powers are a polynomial
+// space, so each refit is a regular minimax problem. This is the heuristic of
+// fpminimax without the lattice reduction, and it loses a fraction of a bit
+// against it.
+//
+// This header needs libquadmath, so it is not a part of the library.
+
+enum class ErrorMetric { Absolute, Relative, ULP };
+
+/// The description of a fit.
+struct RemezProblem {
+    // The function to approximate, in __float128.
+    std::function<__float128(__float128)> fn;
+    __float128 lo, hi;
+    // The powers of the polynomial are [first .. degree]. The lower powers are
+    // zero, e.g. first = 1 for a function with a zero at x = 0.
+    int first = 0;
+    int degree = 3;
+    ErrorMetric metric = ErrorMetric::Relative;
+    // The precision of the coefficients, 24 for float or 53 for double. The
+    // ULP metric is in the ULPs of the same type.
+    int digits = 53;
+};
+
+/// A polynomial and its max error, in the units of the metric.
+struct RemezResult {
+    // The coefficients c0 .. c_degree.
+    std::vector<__float128> coeffs;
+    __float128 error = 0;
+    // The number of exchanges, and whether the error equioscillated.
+    int iterations = 0;
+    bool converged = false;
+};
+
+namespace detail {
+
+/// @return the weight of the error at the exact value \p fx. The points of a
+/// relative or a ULP fit where the function is zero have no weight.
+inline __float128 remez_weight(const RemezProblem &p, __float128 fx) {
+    switch (p.metric) {
+    case ErrorMetric::Absolute:
+        return 1;
+    case ErrorMetric::Relative:
+        return fx == 0 ? 0 : 1 / fabsq(fx);
+    case ErrorMetric::ULP:
+        return fx == 0 ? 0 : scalbnq(1, p.digits - 1 - ilogbq(fx));
+    }
+    return 1;
+}
+
+/// @return \p x, or a point next to it inside the interval if the function
+/// is zero at \p x, where a relative or a ULP error is the limit at the zero.
+inline __float128 avoid_zero(const RemezProblem &p, __float128 x) {
+    if (p.metric == ErrorMetric::Absolute || p.fn(x) != 0) {
+        return x;
+    }
+    __float128 eps = (p.hi - p.lo) * 0x1p-60Q;
+    return x < (p.lo + p.hi) / 2 ? x + eps : x - eps;
+}
+
+/// @return the polynomial \p c at \p x.
+inline __float128 eval_poly(const std::vector<__float128> &c, __float128 x) {
+    __float128 r = 0;
+    for (size_t i = c.size(); i-- > 0;) {
+        r = r * x + c[i];
+    }
+    return r;
+}
+
+/// @return the weighted error of the polynomial \p c at \p x.
+inline __float128 weighted_error(const RemezProblem &p, const std::vector<__float128> &c,
+                                 __float128 x) {
+    __float128 fx = p.fn(x);
+    return remez_weight(p, fx) * (eval_poly(c, x) - fx);
+}
+
+/// Solve the system \p a * x = \p b in place with Gaussian elimination and
+/// partial pivoting. \p a is n x n, in rows.
+inline std::vector<__float128> solve(std::vector<std::vector<__float128>> a,
+                                     std::vector<__float128> b) {
+    size_t n = b.size();
+    for (size_t col = 0; col < n; col++) {
+        size_t pivot = col;
+        for (size_t row = col + 1; row < n; row++) {
+            if (fabsq(a[row][col]) > fabsq(a[pivot][col])) {
+                pivot = row;
+            }
+        }
+        std::swap(a[col], a[pivot]);
+        std::swap(b[col], b[pivot]);
+        for (size_t row = col + 1; row < n; row++) {
+            __float128 factor = a[row][col] / a[col][col];
+            for (size_t k = col; k < n; k++) {
+                a[row][k] -= factor * a[col][k];
+            }
+            b[row] -= factor * b[col];
+        }
+    }
+    std::vector<__float128> x(n);
+    for (size_t row = n; row-- > 0;) {
+        __float128 sum = b[row];
+        for (size_t k = row + 1; k < n; k++) {
+            sum -= a[row][k] * x[k];
+        }
+        x[row] = sum / a[row][row];
+    }
+    return x;
+}
+
+/// An extremum of the weighted error.
+struct Extremum {
+    __float128 x;
+    __float128 err;
+};
+
+/// @return the alternating extrema of the weighted error of \p c: the point
+/// of the largest error in each run of the same sign, on a grid of \p points
+/// Chebyshev nodes, refined with a golden section search.
+inline std::vector<Extremum> find_extrema(const RemezProblem &p, const std::vector<__float128> &c,
+                                          int points) {
+    std::vector<__float128> xs(points), errs(points);
+    __float128 mid = (p.lo + p.hi) / 2, half = (p.hi - p.lo) / 2;
+    for (int i = 0; i < points; i++) {
+        __float128 x = mid - half * cosq(M_PIq * i / (points - 1));
+        x = i == 0 ? p.lo : i == points - 1 ? p.hi : x;
+        xs[i] = avoid_zero(p, x);
+        errs[i] = weighted_error(p, c, xs[i]);
+    }
+
+    std::vector<Extremum> extrema;
+    int i = 0;
+    while (i < points) {
+        // The run of the points with the sign of errs[i], and its largest one.
+        bool negative = errs[i] < 0;
+        int best = i, j = i;
+        for (; j < points && (errs[j] < 0) == negative; j++) {
+            if (fabsq(errs[j]) > fabsq(errs[best])) {
+                best = j;
+            }
+        }
+        // Search between the neighbors of the best grid point.
+        __float128 a = xs[std::max(best - 1, 0)], b = xs[std::min(best + 1, points - 1)];
+        __float128 sign = negative ? -1 : 1;
+        const __float128 ratio = (sqrtq(5) - 1) / 2;
+        for (int iter = 0; iter < 60 && b - a > 0; iter++) {
+            __float128 x1 = b - ratio * (b - a), x2 = a + ratio * (b - a);
+            if (sign * weighted_error(p, c, x1) > sign * weighted_error(p, c, x2)) {
+                b = x2;
+            } else {
+                a = x1;
+            }
+        }
+        Extremum e = { xs[best], errs[best] };
+        __float128 x = avoid_zero(p, (a + b) / 2);
+        __float128 refined = weighted_error(p, c, x);
+        if (sign * refined > sign * e.err) {
+            e = { x, refined };
+        }
+        extrema.push_back(e);
+        i = j;
+    }
+    return extrema;
+}
+
+/// Reduce the alternating \p extrema to \p n points that still alternate,
+/// and keep the largest errors.
+inline void reduce_extrema(std::vector<Extremum> &extrema, size_t n) {
+    while (extrema.size() > n) {
+        if (extrema.size() == n + 1) {
+            // Drop the smaller end.
+            if (fabsq(extrema.front().err) < fabsq(extrema.back().err)) {
+                extrema.erase(extrema.begin());
+            } else {
+                extrema.pop_back();
+            }
+            continue;
+        }
+        size_t smallest = 0;
+        for (size_t i = 1; i < extrema.size(); i++) {
+            if (fabsq(extrema[i].err) < fabsq(extrema[smallest].err)) {
+                smallest = i;
+            }
+        }
+        if (smallest == 0 || smallest == extrema.size() - 1) {
+            extrema.erase(extrema.begin() + smallest);
+            continue;
+        }
+        // The neighbors have the same sign, so drop the smaller one too.
+        size_t other = fabsq(extrema[smallest - 1].err) < fabsq(extrema[smallest + 1].err)
+                           ? smallest - 1
+                           : smallest + 1;
+        extrema.erase(extrema.begin() + std::max(smallest, other));
+        extrema.erase(extrema.begin() + std::min(smallest, other));
+    }
+}
+
+/// @return the max weighted error of the polynomial \p c on \p p.
+inline __float128 max_error(const RemezProblem &p, const std::vector<__float128> &c) {
+    __float128 err = 0;
+    for (const Extremum &e : find_extrema(p, c, 256 * (p.degree + 2) + 1)) {
+        err = fmaxq(err, fabsq(e.err));
+    }
+    return err;
+}
+
+/// Fit the coefficients of the powers \p powers of \p p, with the other
+/// coefficients of \p c fixed, and return the result.
+inline RemezResult remez(const RemezProblem &p, std::vector<__float128> c,
+                         const std::vector<int> &powers) {
+    int m = int(powers.size());
+    int points = 256 * (m + 1) + 1;
+    RemezResult res;
+    // The fixed part of the polynomial.
+    std::vector<__float128> fixed = c;
+    for (int k : powers) {
+        fixed[k] = 0;
+    }
+
+    // Start from the extrema of the Chebyshev polynomial of degree m.
+    std::vector<__float128> nodes(m + 1);
+    __float128 mid = (p.lo + p.hi) / 2, half = (p.hi - p.lo) / 2;
+    for (int i = 0; i <= m; i++) {
+        nodes[i] = avoid_zero(p, mid - half * cosq(M_PIq * i / std::max(m, 1)));
+    }
+
+    for (res.iterations = 0; m > 0 && res.iterations < 100; res.iterations++) {
+        // Solve for the coefficients and the levelled error E:
+        //   w(x_i) * (p(x_i) - f(x_i)) = (-1)^i * E.
+        std::vector<std::vector<__float128>> a(m + 1, std::vector<__float128>(m + 1));
+        std::vector<__float128> b(m + 1);
+        for (int i = 0; i <= m; i++) {
+            __float128 x = nodes[i], fx = p.fn(x);
+            for (int j = 0; j < m; j++) {
+                a[i][j] = powq(x, powers[j]);
+            }
+            __float128 w = remez_weight(p, fx);
+            a[i][m] = w == 0 ? 0 : (i % 2 ? -1 : 1) / w;
+            b[i] = fx - eval_poly(fixed, x);
+        }
+        std::vector<__float128> sol = solve(a, b);
+        for (int j = 0; j < m; j++) {
+            c[powers[j]] = sol[j];
+        }
+
+        // The error of an exact fit is the noise of __float128, which does
+        // not equioscillate, and can have too few sign changes to exchange.
+        std::vector<Extremum> extrema = find_extrema(p, c, points);
+        if (extrema.size() < size_t(m + 1)) {
+            res.converged = max_error(p, c) < 1e-30Q;
+            break;
+        }
+        reduce_extrema(extrema, m + 1);
+        __float128 max_err = 0, min_err = INFINITY;
+        for (int i = 0; i <= m; i++) {
+            nodes[i] = extrema[i].x;
+            max_err = fmaxq(max_err, fabsq(extrema[i].err));
+            min_err = fminq(min_err, fabsq(extrema[i].err));
+        }
+        if (max_err - min_err <= 1e-6Q * max_err || max_err < 1e-30Q) {
+            res.converged = true;
+            break;
+        }
+    }
+
+    res.coeffs = c;
+    res.error = max_error(p, c);
+    return res;
+}
+
+/// @return the powers [first .. degree] of \p p.
+inline std::vector<int> all_powers(const RemezProblem &p) {
+    std::vector<int> powers;
+    for (int k = p.first; k <= p.degree; k++) {
+        powers.push_back(k);
+    }
+    return powers;
+}
+
+/// @return \p x rounded to float, for 24 \p digits, or to double.
+inline __float128 round_coefficient(__float128 x, int digits) {
+    return digits == 24 ? __float128(float(x)) : __float128(double(x));
+}
+
+/// @return the neighbor of the float or the double \p x, in the direction
+/// \p dir.
+inline __float128 next_coefficient(__float128 x, int digits, int dir) {
+    if (digits == 24) {
+        return std::nextafter(float(x), dir > 0 ? INFINITY : -INFINITY);
+    }
+    return std::nextafter(double(x), dir > 0 ? INFINITY : -INFINITY);
+}
+
+/// Round the coefficients one at a time, from the lowest power up if not
+/// \p descending, and fit the rest again after each rounding. The result
+/// converged if all the fits converged.
+inline RemezResult round_in_order(const RemezProblem &p, bool descending) {
+    RemezResult res;
+    res.coeffs.assign(p.degree + 1, 0);
+    res.converged = true;
+    std::vector<int> powers = all_powers(p);
+    while (!powers.empty()) {
+        RemezResult fit = remez(p, res.coeffs, powers);
+        res.coeffs = fit.coeffs;
+        res.iterations += fit.iterations;
+        res.converged = res.converged && fit.converged;
+        int k = descending ? powers.back() : powers.front();
+        res.coeffs[k] = round_coefficient(res.coeffs[k], p.digits);
+        powers.erase(descending ? powers.end() - 1 : powers.begin());
+    }
+    res.error = max_error(p, res.coeffs);
+    return res;
+}
+
+} // namespace detail
+
+/// @return the minimax polynomial of \p p, with the exact coefficients.
+inline RemezResult minimax(const RemezProblem &p) {
+    return detail::remez(p, std::vector<__float128>(p.degree + 1, 0), detail::all_powers(p));
+}
+
+/// @return a polynomial with the coefficients rounded to the type of \p p,
+/// and its max error with the rounded coefficients.
+///
+/// The coefficients are rounded in both orders: from the highest power down,
+/// where the lower powers absorb the rounding errors, and from the lowest
+/// power up, which keeps the large coefficients near their exact values.
+/// Then each coefficient moves by one ULP at a time, for a few passes, while
+/// the error drops by more than 0.1%. The result converged if all the fits
+/// of both orders converged.
+inline RemezResult fpminimax(const RemezProblem &p) {
+    RemezResult res;
+    res.error = INFINITY;
+    res.converged = true;
+    for (bool descending : { true, false }) {
+        RemezResult r = detail::round_in_order(p, descending);
+        res.iterations += r.iterations;
+        res.converged = res.converged && r.converged;
+        if (r.error < res.error) {
+            res.coeffs = r.coeffs;
+            res.error = r.error;
+        }
+    }
+
+    bool improved = true;
+    for (int pass = 0; pass < 8 && improved; pass++) {
+        improved = false;
+        for (int k : detail::all_powers(p)) {
+            for (int dir : { -1, 1 }) {
+                std::vector<__float128> c = res.coeffs;
+                c[k] = detail::next_coefficient(c[k], p.digits, dir);
+                __float128 err = detail::max_error(p, c);
+                if (err < res.error * 0.999Q) {
+                    res.coeffs = c;
+                    res.error = err;
+                    improved = true;
+                }
+            }
+        }
+    }
+    return res;
+}
+
+/// The fits of a piecewise polynomial, see piecewise.h.
+struct PiecewiseResult {
+    // The interval [lo .. hi] is cut into equal segments, and the polynomial
+    // of segment i is in t = (x - lo) * scale - i, in [0 .. 1].
+    __float128 lo, hi, scale;
+    std::vector<RemezResult> segments;
+    __float128 error = 0;
+};
+
+/// Fit \p segments polynomials of the degree and the metric of \p p to the
+/// equal segments of [p.lo .. p.hi], with the coefficients rounded to the
+/// type of \p p. The segments where the function is zero at the start fit
+/// from the power 1, unless p.first is higher.
+inline PiecewiseResult fit_piecewise(const RemezProblem &p, unsigned segments) {
+    PiecewiseResult res;
+    res.lo = detail::round_coefficient(p.lo, p.digits);
+    res.hi = p.hi;
+    res.scale = detail::round_coefficient(segments / (p.hi - res.lo), p.digits);
+    for (unsigned i = 0; i < segments; i++) {
+        RemezProblem seg = p;
+        __float128 start = res.lo + i / res.scale, width = 1 / res.scale;
+        seg.fn = [&p, start, width](__float128 t) { return p.fn(start + t * width); };
+        seg.lo = 0;
+        seg.hi = 1;
+        if (p.fn(start) == 0) {
+            seg.first = std::max(p.first, 1);
+        }
+        res.segments.push_back(fpminimax(seg));
+        res.error = fmaxq(res.error, res.segments.back().error);
+    }
+    return res;
+}
+
+/// The functions of the generators, by name.
+struct NamedFunction {
+    const char *name;
+    __float128 (*fn)(__float128);
+};
+
+inline const NamedFunction named_functions[] = {
+    { "log2", log2q },
+    { "log", logq },
+    { "log1p", log1pq },
+    { "exp", expq },
+    { "exp2", exp2q },
+    { "expm1", expm1q },
+    { "erf", erfq },
+    { "erfc", erfcq },
+    { "tanh", tanhq },
+    { "sin", sinq },
+    { "cos", cosq },
+    // The CDF of the standard normal distribution.
+    { "normal_cdf", [](__float128 x) { return erfcq(-x / sqrtq(2)) / 2; } },
+};
+
+/// @return the function \p name, or null if there is none.
+inline __float128 (*find_function(const std::string &name))(__float128) {
+    for (const NamedFunction &f : named_functions) {
+        if (name == f.name) {
+            return f.fn;
+        }
+    }
+    return nullptr;
+}
+
+/// Print the names of the functions of named_functions to \p out.
+inline void print_function_names(FILE *out) {
+    fprintf(out, "The functions are:");
+    for (const NamedFunction &f : named_functions) {
+        fprintf(out, " %s", f.name);
+    }
+    fprintf(out, "\n");
+}
+
+/// @return the name of \p metric, for the comments of the tables.
+inline const char *metric_name(ErrorMetric metric) {
+    switch (metric) {
+    case ErrorMetric::Absolute:
+        return "absolute";
+    case ErrorMetric::Relative:
+        return "relative";
+    case ErrorMetric::ULP:
+        return "ULP";
+    }
+    return "";
+}
+
+/// The command line of the generators remez and piecewise.
+struct GeneratorArgs {
+    // The name of the table, and the header to write it to, or null for
+    // stdout.
+    std::string name;
+    const char *header = nullptr;
+    // The arguments that are not options: the function, the interval, and
+    // the degree for remez.
+    std::vector<std::string> args;
+};
+
+/// Parse the options of the generators in \p argv: --metric abs|rel|ulp and
+/// --type float|double into \p p, --name and --header into \p g, and the
+/// integer options of the tool, like { "--first", &p.first }, in
+/// \p int_options. The other arguments go to g.args.
+/// @return False if the value of --metric or --type is not valid.
+inline bool parse_generator_args(int argc, char **argv, RemezProblem &p, GeneratorArgs &g,
+                                 const std::vector<std::pair<std::string, int *>> &int_options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        auto int_option = std::find_if(int_options.begin(), int_options.end(),
+                                       [&](const auto &option) { return option.first == arg; });
+        if (int_option != int_options.end() && has_value) {
+            *int_option->second = atoi(argv[++i]);
+        } else if (arg == "--metric" && has_value) {
+            std::string metric = argv[++i];
+            if (metric != "abs" && metric != "rel" && metric != "ulp") {
+                return false;
+            }
+            p.metric = metric == "abs"   ? ErrorMetric::Absolute
+                       : metric == "rel" ? ErrorMetric::Relative
+                                         : ErrorMetric::ULP;
+        } else if (arg == "--type" && has_value) {
+            std::string type = argv[++i];
+            if (type != "float" && type != "double") {
+                return false;
+            }
+            p.digits = type == "float" ? 24 : 53;
+        } else if (arg == "--name" && has_value) {
+            g.name = argv[++i];
+        } else if (arg == "--header" && has_value) {
+            g.header = argv[++i];
+        } else {
+            g.args.push_back(arg);
+        }
+    }
+    return true;
+}
+
+/// Set the function and the interval of \p p from the first three arguments
+/// of \p args: function lo hi.
+/// @return False if the function is not known, or the interval is empty.
+inline bool parse_function_and_interval(const std::vector<std::string> &args, RemezProblem &p) {
+    p.fn = find_function(args[0]);
+    p.lo = strtoflt128(args[1].c_str(), nullptr);
+    p.hi = strtoflt128(args[2].c_str(), nullptr);
+    return p.fn && p.lo < p.hi;
+}
+
+/// Print the table of \p g with \p print, to stdout, or to the header
+/// g.header. The header has an include guard from the name of the table, the
+/// includes \p includes, and a note that \p tool generated it. \p comment is
+/// the description of the fit, which is also printed when the header is
+/// written.
+/// @return the exit code of the tool.
+inline int emit_table(const GeneratorArgs &g, const char *tool, const char *includes,
+                      const std::string &comment, const std::function<void(FILE *)> &print) {
+    if (!g.header) {
+        print(stdout);
+        return 0;
+    }
+    FILE *out = fopen(g.header, "w");
+    if (!out) {
+        fprintf(stderr, "error: can't write %s: %s\n", g.header, strerror(errno));
+        return 1;
+    }
+    std::string guard = g.name;
+    for (char &ch : guard) {
+        ch = toupper(ch);
+    }
+    fprintf(out, "#ifndef %s_H\n#define %s_H\n\n%s", guard.c_str(), guard.c_str(), includes);
+    fprintf(out, "// Generated by %s.\n", tool);
+    print(out);
+    fprintf(out, "\n#endif // %s_H\n", guard.c_str());
+    fclose(out);
+    printf("%s\nWrote %s\n", comment.c_str(), g.header);
+    return 0;
+}
+
+/// Print the coefficients of \p r as the constexpr table \p name, in the type
+/// of \p p, after the comment \p comment.
+inline void print_coefficients(FILE *out, const std::string &name, const RemezProblem &p,
+                               const RemezResult &r, const std::string &comment) {
+    const char *type = p.digits == 24 ? "float" : "double";
+    fprintf(out, "// %s\n", comment.c_str());
+    fprintf(out, "inline constexpr %s %s[%zu] = {", type, name.c_str(), r.coeffs.size());
+    for (size_t i = 0; i < r.coeffs.size(); i++) {
+        if (i % 4 == 0) {
+            fprintf(out, "\n   ");
+        }
+        if (p.digits == 24) {
+            fprintf(out, " %af,", double(float(r.coeffs[i])));
+        } else {
+            fprintf(out, " %a,", double(r.coeffs[i]));
+        }
+    }
+    fprintf(out, "\n};\n");
+}
+
+/// Print the segments of \p r as the constexpr PiecewisePoly \p name of
+/// piecewise.h, in the type of \p p, after the comment \p comment.
+inline void print_piecewise(FILE *out, const std::string &name, const RemezProblem &p,
+                            const PiecewiseResult &r, const std::string &comment) {
+    const char *type = p.digits == 24 ? "float" : "double";
+    const char *suffix = p.digits == 24 ? "f" : "";
+    fprintf(out, "// %s\n", comment.c_str());
+    fprintf(out, "inline constexpr PiecewisePoly<%s, %zu, %d> %s = {\n", type, r.segments.size(),
+            p.degree + 1, name.c_str());
+    fprintf(out, "    %a%s,\n    %a%s,\n    {\n", double(r.lo), suffix, double(r.scale), suffix);
+    for (const RemezResult &seg : r.segments) {
+        fprintf(out, "        {");
+        for (size_t i = 0; i < seg.coeffs.size(); i++) {
+            if (i && i % 4 == 0) {
+                fprintf(out, "\n         ");
+            }
+            fprintf(out, " %a%s,", double(seg.coeffs[i]), suffix);
+        }
+        fprintf(out, " },\n");
+    }
+    fprintf(out, "    },\n};\n");
+}
+
+#endif // REMEZ_H
@@ -0,0 +1,112 @@
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "sum_log.h"
+#include "util.h"
+
+// Compute the sum in long double as the ground truth.
+long double accurate_sum_log(const float *x, size_t n) {
+    long double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += logl(x[i]);
+    }
+    return sum;
+}
+
+// The straightforward implementation, with a libm log per element.
+double __attribute__((noinline)) libm_sum_log(const float *x, size_t n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += logf(x[i]);
+    }
+    return sum;
+}
+
+// The straightforward implementation, with a my_log per element.
+double __attribute__((noinline)) my_log_sum_log(const float *x, size_t n) {
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += log_positive(x[i]);
+    }
+    return sum;
+}
+
+/// @return \p count random values over a wide range of exponents.
+std::vector<float> generate_likelihoods(unsigned count) {
+    std::vector<float> e = generate_test_vector<float>(-140., 120., count);
+    std::vector<float> res;
+    for (auto elem : e) {
+        res.push_back(exp2f(elem));
+    }
+    return res;
+}
+
+void check() {
+    std::vector<float> x = { 1, 2, 4, 0.5 };
+    assert(std::abs(sum_log(x.data(), x.size()) - 2 * log(2.)) < 1e-15);
+    x.push_back(0);
+    assert(sum_log(x.data(), x.size()) == -INFINITY);
+    x.push_back(INFINITY);
+    assert(std::isnan(sum_log(x.data(), x.size())));
+    x = { 3, INFINITY };
+    assert(sum_log(x.data(), x.size()) == INFINITY);
+    x = { 3, -1 };
+    assert(std::isnan(sum_log(x.data(), x.size())));
+    x = { 3, -0.f };
+    assert(sum_log(x.data(), x.size()) == -INFINITY);
+    x = { 3, NAN };
+    assert(std::isnan(sum_log(x.data(), x.size())));
+    assert(sum_log(x.data(), 0) == 0);
+}
+
+int main(int argc, char **argv) {
+    check();
+
+    // Check sizes that don't divide the block and the chunk sizes.
+    std::vector<float> x = generate_likelihoods(1000003);
+    for (size_t n : { 1, 7, 513, 4096, 4097, 1000003 }) {
+        double sum = sum_log(x.data(), n);
+        long double ref = accurate_sum_log(x.data(), n);
+        printf("n = %7zu, sum = %.17g, error = %.3g\n", n, sum, double(sum - ref));
+    }
+
+    std::vector<double> prefix((x.size() + SumLogBlock - 1) / SumLogBlock);
+    prefix_sum_log(x.data(), x.size(), prefix.data());
+    double max_error = 0;
+    for (size_t b = 0; b < prefix.size(); b++) {
+        size_t n = std::min(x.size(), (b + 1) * SumLogBlock);
+        max_error = std::max(max_error, double(std::abs(prefix[b] - accurate_sum_log(x.data(), n))));
+    }
+    printf("prefix: %zu blocks, max error = %.3g\n", prefix.size(), max_error);
+
+    // The kernels are pure, so shift the inputs in each iteration to prevent
+    // the compiler from hoisting the calls out of the loop.
+    const int iterations = 100;
+    double sum = 0;
+    auto t1 = high_resolution_clock::now();
+    for (int iter = 0; iter < iterations; iter++) {
+        sum += sum_log(x.data() + (iter & 1), x.size() - 1);
+    }
+    auto t2 = high_resolution_clock::now();
+    for (int iter = 0; iter < iterations; iter++) {
+        sum += my_log_sum_log(x.data() + (iter & 1), x.size() - 1);
+    }
+    auto t3 = high_resolution_clock::now();
+    for (int iter = 0; iter < iterations; iter++) {
+        sum += libm_sum_log(x.data() + (iter & 1), x.size() - 1);
+    }
+    auto t4 = high_resolution_clock::now();
+    std::cout << "sum = " << sum << "\n";
+    std::cout << "name = sum_log, time = " << duration_cast<milliseconds>(t2 - t1).count()
+              << "ms\n";
+    std::cout << "name = my_log_sum_log, time = " << duration_cast<milliseconds>(t3 - t2).count()
+              << "ms\n";
+    std::cout << "name = libm_sum_log, time = " << duration_cast<milliseconds>(t4 - t3).count()
+              << "ms\n";
+    return 0;
+}
@@ -0,0 +1,142 @@
+#ifndef SUM_LOG_H
+#define SUM_LOG_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "log_accurate.h"
+#include "util.h"
+
+/// The number of independent product accumulators.
+constexpr unsigned SumLogLanes = 8;
+/// The number of mantissas in [1 .. 2) that a lane multiplies before it is
+/// renormalized. The product is below 2^64, so it can't overflow.
+constexpr unsigned SumLogRenormSteps = 64;
+/// The number of values that share a single call to log.
+constexpr size_t SumLogBlock = 4096;
+
+/// Add the exponent of the positive double \p x to \p E.
+/// @return the mantissa of \p x in the range [1 .. 2).
+inline double split_exponent(double x, int64_t &E) {
+    uint64_t bits = bit_cast<uint64_t, double>(x);
+    E += int64_t(bits >> 52) - 1023;
+    return bit_cast<double, uint64_t>((bits & 0xFFFFFFFFFFFFF) | 0x3ff0000000000000);
+}
+
+/// Records the special inputs of a reduction.
+struct SumLogFlags {
+    bool zero_ = false;
+    bool inf_ = false;
+    bool nan_ = false;
+
+    void add(float x) {
+        zero_ |= x == 0;
+        inf_ |= x == INFINITY;
+        // Negative numbers and NaNs.
+        nan_ |= !(x >= 0);
+    }
+    /// @return the reduction of \p sum, after applying the special values.
+    double apply(double sum) const {
+        if (nan_ || (zero_ && inf_)) {
+            return NAN;
+        } else if (zero_) {
+            return -INFINITY;
+        } else if (inf_) {
+            return INFINITY;
+        }
+        return sum;
+    }
+};
+
+/// @return the sum of log(x[i]) for up to SumLogBlock values in \p x.
+/// The mantissas are multiplied, and the exponents are summed exactly, so
+/// log is called only once. The special values are recorded in \p flags.
+/// The valid inputs have the bit patterns [1 .. 0x7f7fffff], so the block
+/// tracks the range of the bit patterns with min and max reductions, which
+/// vectorize, and classifies the inputs one by one only if the range is not
+/// valid.
+inline double sum_log_block(const float *x, size_t n, SumLogFlags &flags) {
+    double prod[SumLogLanes];
+    int64_t E[SumLogLanes];
+    // The range of the bit patterns of each lane.
+    uint32_t lo[SumLogLanes];
+    uint32_t hi[SumLogLanes];
+    for (unsigned l = 0; l < SumLogLanes; l++) {
+        prod[l] = 1;
+        E[l] = 0;
+        lo[l] = 0xffffffff;
+        hi[l] = 0;
+    }
+
+    const unsigned chunk = SumLogLanes * SumLogRenormSteps;
+    size_t i = 0;
+    for (; i + chunk <= n; i += chunk) {
+        for (unsigned s = 0; s < chunk; s += SumLogLanes) {
+            for (unsigned l = 0; l < SumLogLanes; l++) {
+                // The conversion to double normalizes the float denormals.
+                float v = x[i + s + l];
+                uint32_t bits = bit_cast<uint32_t, float>(v);
+                lo[l] = std::min(lo[l], bits);
+                hi[l] = std::max(hi[l], bits);
+                prod[l] *= split_exponent(v, E[l]);
+            }
+        }
+        // Move the exponent of the products to the integer sums.
+        for (unsigned l = 0; l < SumLogLanes; l++) {
+            prod[l] = split_exponent(prod[l], E[l]);
+        }
+    }
+    // The tail is shorter than a chunk, so it fits in a single lane.
+    for (; i < n; i++) {
+        uint32_t bits = bit_cast<uint32_t, float>(x[i]);
+        lo[0] = std::min(lo[0], bits);
+        hi[0] = std::max(hi[0], bits);
+        prod[0] *= split_exponent(x[i], E[0]);
+    }
+    prod[0] = split_exponent(prod[0], E[0]);
+
+    // The product of the lanes is below 2^SumLogLanes.
+    double m = 1;
+    int64_t exponent = 0;
+    for (unsigned l = 0; l < SumLogLanes; l++) {
+        m *= prod[l];
+        exponent += E[l];
+        lo[0] = std::min(lo[0], lo[l]);
+        hi[0] = std::max(hi[0], hi[l]);
+    }
+    if (lo[0] == 0 || hi[0] >= 0x7f800000) {
+        for (i = 0; i < n; i++) {
+            flags.add(x[i]);
+        }
+    }
+    double log2 = bit_cast<double, uint64_t>(0x3fe62e42fefa39ef);
+    return exponent * log2 + log_positive(m);
+}
+
+/// @return the sum of log(x[i]) for the \p n values in \p x. This is the log
+/// of the product of the values, and it calls log once per SumLogBlock values.
+KERNEL_API double sum_log(const float *x, size_t n) {
+    SumLogFlags flags;
+    double sum = 0;
+    for (size_t i = 0; i < n; i += SumLogBlock) {
+        sum += sum_log_block(x + i, std::min(SumLogBlock, n - i), flags);
+    }
+    return flags.apply(sum);
+}
+
+/// Compute the cumulative sums of log(x[i]) at the block boundaries. The
+/// output \p out[b] is the sum of the logs of the first (b + 1) * SumLogBlock
+/// values (or of all the values, for the last block), so \p out must have
+/// room for ceil(n / SumLogBlock) values.
+KERNEL_API void prefix_sum_log(const float *x, size_t n, double *out) {
+    SumLogFlags flags;
+    double sum = 0;
+    for (size_t i = 0; i < n; i += SumLogBlock) {
+        sum += sum_log_block(x + i, std::min(SumLogBlock, n - i), flags);
+        out[i / SumLogBlock] = flags.apply(sum);
+    }
+}
+
+#endif // SUM_LOG_H
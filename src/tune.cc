@@ -0,0 +1,344 @@
+#include <cassert>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "fast_log.h"
+#include "reference.h"
+#include "util.h"
+
+// Pick the fastest configuration of the log and the exp kernels that meets an
+// error budget, on the local machine:
+//
+//   tune [--budget ulps] [--exhaustive] [--header path]
+//
+// The configurations are the kernels of the tree, with their polynomial
+// schemes, their tables and their internal precision, and the domain contract
+// of the tuning domain. The tool measures the max ULP error of each one with
+// the Verifier against reference.h, and the speed of an inlined loop over
+// the scalar kernel, like the loops of the callers. It prints the Pareto front
+// of the configurations, which are not both slower and less accurate than
+// another one, and writes a header that defines tuned_log and tuned_exp as
+// the fastest configurations within the budget.
+//
+// The tuning domain of log is the positive normal floats, and of exp is
+// [-87 .. 88] (see domain.h), so the tuned kernels have the same contracts.
+// The Verifier samples 2^22 inputs of each range, or checks all of them with
+// --exhaustive. This program is built without NOINLINE_KERNELS, so the kernels
+// inline into the benchmark loops, and with -march=native, so the header is
+// specific to the instruction set of the machine.
+
+// The configurations, as float kernels.
+template <PolyScheme Scheme> inline float fastlog2_float(float x) {
+    return float(fastlog2<Scheme>(double(x)));
+}
+template <PolyScheme Scheme> inline float fast_exp_float(float x) {
+    return float(fast_exp<Scheme>(double(x)));
+}
+inline float log_double_double(float x) { return float(my_log_double(double(x))); }
+
+/// A configuration of a kernel, and its measurements.
+struct Config {
+    const char *name;
+    // The body of the tuned function in the header, on the argument x.
+    const char *expr;
+    float (*scalar)(float);
+    void (*loop)(const float *, float *, size_t);
+    double max_ulp = 0;
+    double ns_per_elem = 0;
+};
+
+/// Compute \p out[i] = Fn(\p in[i]) for \p n elements, with Fn inlined.
+template <float (*Fn)(float)>
+void __attribute__((noinline)) loop(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = Fn(in[i]);
+    }
+}
+
+template <float (*Fn)(float)> Config make_config(const char *name, const char *expr) {
+    return { name, expr, Fn, loop<Fn> };
+}
+
+std::vector<Config> log_configs() {
+    return {
+        make_config<mitchell_log>("mitchell_log (int, 64 segments)", "mitchell_log(x)"),
+        make_config<fastlog2_float<PolyScheme::Horner>>(
+            "fastlog2 (double, degree 3, Horner)",
+            "float(fastlog2<PolyScheme::Horner>(double(x)))"),
+        make_config<fastlog2_float<PolyScheme::Estrin>>(
+            "fastlog2 (double, degree 3, Estrin)",
+            "float(fastlog2<PolyScheme::Estrin>(double(x)))"),
+        make_config<fastlog2_float<PolyScheme::EvenOdd>>(
+            "fastlog2 (double, degree 3, EvenOdd)",
+            "float(fastlog2<PolyScheme::EvenOdd>(double(x)))"),
+        make_config<log_f32_reduced>("log_f32_reduced (float, degree 7)", "log_f32_reduced(x)"),
+        make_config<my_log_float>("my_log_float (float, 91 entries)", "my_log_float(x)"),
+        make_config<my_log_in<AnyInput>>("my_log (double, table)", "my_log_in<AnyInput>(x)"),
+        make_config<my_log_in<PositiveNormal>>("my_log<PositiveNormal> (double, table)",
+                                               "my_log_in<PositiveNormal>(x)"),
+        make_config<log_double_double>("my_log_double (double-double)",
+                                       "float(my_log_double(double(x)))"),
+    };
+}
+
+std::vector<Config> exp_configs() {
+    return {
+        make_config<fast_exp_float<PolyScheme::Horner>>(
+            "fast_exp (double, degree 3, Horner)",
+            "float(fast_exp<PolyScheme::Horner>(double(x)))"),
+        make_config<fast_exp_float<PolyScheme::Estrin>>(
+            "fast_exp (double, degree 3, Estrin)",
+            "float(fast_exp<PolyScheme::Estrin>(double(x)))"),
+        make_config<fast_exp_float<PolyScheme::EvenOdd>>(
+            "fast_exp (double, degree 3, EvenOdd)",
+            "float(fast_exp<PolyScheme::EvenOdd>(double(x)))"),
+        make_config<exp_f32_reduced>("exp_f32_reduced (float, degree 5)", "exp_f32_reduced(x)"),
+        make_config<my_exp_in<AnyInput>>("my_exp (double, two tables)", "my_exp_in<AnyInput>(x)"),
+        make_config<my_exp_in<SafeExpRange>>("my_exp<SafeExpRange> (double, two tables)",
+                                             "my_exp_in<SafeExpRange>(x)"),
+    };
+}
+
+/// The max ULP error of \p c on the bit patterns of the ranges \p ranges,
+/// with \p count samples of each, or all the patterns if \p count is zero.
+/// @return NaN if a scan was cancelled.
+double measure_error(const Config &c, void (*ref)(const float *, DoubleDouble *, size_t),
+                     const std::vector<std::pair<uint64_t, uint64_t>> &ranges, uint64_t count) {
+    double max_err = 0;
+    for (auto range : ranges) {
+        Verifier<float, unsigned, 64, 16> v;
+        double err = v.ulp_errors(c.scalar, ref, range.first, range.second, count);
+        // std::max would drop the NaN of a cancelled scan.
+        if (std::isnan(err)) {
+            return err;
+        }
+        max_err = std::max(max_err, err);
+    }
+    return max_err;
+}
+
+/// @return the best time of a few runs of the loop of \p c on \p iv, in
+/// nanoseconds per element.
+double measure_speed(const Config &c, const std::vector<float> &iv) {
+    constexpr int Iterations = 2000;
+    std::vector<float> out(iv.size());
+    double best = INFINITY;
+    for (int run = 0; run < 3; run++) {
+        auto t1 = high_resolution_clock::now();
+        for (int iter = 0; iter < Iterations; iter++) {
+            c.loop(iv.data(), out.data(), iv.size());
+        }
+        auto t2 = high_resolution_clock::now();
+        best = std::min(best, duration<double>(t2 - t1).count());
+    }
+    return best * 1e9 / (double(Iterations) * iv.size());
+}
+
+/// @return the configurations that no other configuration beats in both the
+/// error and the speed, from the fastest to the most accurate.
+std::vector<Config> pareto_front(std::vector<Config> configs) {
+    std::sort(configs.begin(), configs.end(), [](const Config &a, const Config &b) {
+        return a.ns_per_elem < b.ns_per_elem ||
+               (a.ns_per_elem == b.ns_per_elem && a.max_ulp < b.max_ulp);
+    });
+    std::vector<Config> front;
+    for (const Config &c : configs) {
+        if (front.empty() || c.max_ulp < front.back().max_ulp) {
+            front.push_back(c);
+        }
+    }
+    return front;
+}
+
+/// @return the fastest configuration of \p front within \p budget ULPs, or
+/// null if there is none.
+const Config *select_config(const std::vector<Config> &front, double budget) {
+    for (const Config &c : front) {
+        if (c.max_ulp <= budget) {
+            return &c;
+        }
+    }
+    return nullptr;
+}
+
+/// @return the model name of the CPU, from /proc/cpuinfo.
+std::string cpu_name() {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            size_t colon = line.find(':');
+            return colon == std::string::npos ? line : line.substr(colon + 2);
+        }
+    }
+    return "unknown CPU";
+}
+
+/// @return the macro of the widest vector extension this program is built
+/// for, which the header checks, or null for none.
+const char *isa_macro() {
+#if defined(__AVX512F__)
+    return "__AVX512F__";
+#elif defined(__AVX2__)
+    return "__AVX2__";
+#elif defined(__AVX__)
+    return "__AVX__";
+#elif defined(__ARM_NEON)
+    return "__ARM_NEON";
+#else
+    return nullptr;
+#endif
+}
+
+/// Write the definition of the tuned kernel \p fn to \p out.
+void write_kernel(FILE *out, const char *fn, const char *contract, const Config &c) {
+    fprintf(out, "/// %s: %.3g ULP, %.3f ns per element.\n", c.name, c.max_ulp, c.ns_per_elem);
+    fprintf(out, "/// The inputs must be in %s (see domain.h).\n", contract);
+    fprintf(out, "inline float %s(float x) { return %s; }\n\n", fn, c.expr);
+    fprintf(out, "/// Compute \\p out[i] = %s(\\p in[i]) for \\p n elements.\n", fn);
+    fprintf(out, "inline void %s(const float *in, float *out, size_t n) {\n", fn);
+    fprintf(out, "    for (size_t i = 0; i < n; i++) {\n");
+    fprintf(out, "        out[i] = %s(in[i]);\n", fn);
+    fprintf(out, "    }\n}\n\n");
+}
+
+/// Write the header that selects \p log_winner and \p exp_winner to \p out.
+void write_header(FILE *out, double budget, const Config &log_winner, const Config &exp_winner) {
+    const char *isa = isa_macro();
+    fprintf(out, "#ifndef TUNED_H\n#define TUNED_H\n\n");
+    fprintf(out, "// Generated by tune, for the error budget of %g ULP, on %s.\n", budget,
+            cpu_name().c_str());
+    fprintf(out, "// The kernels are the fastest ones within the budget on this machine, and\n");
+    fprintf(out, "// another machine or another budget may select other kernels.\n\n");
+    fprintf(out, "#include <cstddef>\n\n#include \"fast_log.h\"\n\n");
+    if (isa) {
+        fprintf(out, "#ifndef %s\n", isa);
+        fprintf(out, "#warning \"tuned.h was tuned for %s, run tune on this target\"\n", isa);
+        fprintf(out, "#endif\n\n");
+    }
+    write_kernel(out, "tuned_log", "PositiveNormal", log_winner);
+    write_kernel(out, "tuned_exp", "SafeExpRange", exp_winner);
+    fprintf(out, "#endif // TUNED_H\n");
+}
+
+/// Measure \p configs, and print them and their Pareto front.
+/// @return the Pareto front, or an empty front if a scan was cancelled.
+std::vector<Config> tune(const char *title, std::vector<Config> configs,
+                         void (*ref)(const float *, DoubleDouble *, size_t),
+                         const std::vector<std::pair<uint64_t, uint64_t>> &ranges,
+                         uint64_t count, const std::vector<float> &iv) {
+    printf("\n%s:\n", title);
+    for (Config &c : configs) {
+        c.max_ulp = measure_error(c, ref, ranges, count);
+        if (std::isnan(c.max_ulp)) {
+            return {};
+        }
+        c.ns_per_elem = measure_speed(c, iv);
+        printf("  %-45s %12.3g ULP %8.3f ns\n", c.name, c.max_ulp, c.ns_per_elem);
+    }
+    std::vector<Config> front = pareto_front(configs);
+    printf("Pareto front:\n");
+    for (const Config &c : front) {
+        printf("  %-45s %12.3g ULP %8.3f ns\n", c.name, c.max_ulp, c.ns_per_elem);
+    }
+    return front;
+}
+
+void check() {
+    // The loops match the scalar kernels.
+    std::vector<float> in = generate_test_vector<float>(0.001, 88, 1000);
+    std::vector<float> out(in.size());
+    for (auto configs : { log_configs(), exp_configs() }) {
+        for (const Config &c : configs) {
+            c.loop(in.data(), out.data(), in.size());
+            for (size_t i = 0; i < in.size(); i++) {
+                float r = c.scalar(in[i]);
+                assert(memcmp(&r, &out[i], sizeof(float)) == 0);
+            }
+        }
+    }
+
+    // The front drops the configurations that are slower and less accurate.
+    std::vector<Config> configs(4, log_configs()[0]);
+    double measurements[4][2] = { { 100, 1 }, { 0.5, 5 }, { 200, 2 }, { 2, 3 } };
+    for (size_t i = 0; i < configs.size(); i++) {
+        configs[i].max_ulp = measurements[i][0];
+        configs[i].ns_per_elem = measurements[i][1];
+    }
+    std::vector<Config> front = pareto_front(configs);
+    assert(front.size() == 3 && front[0].ns_per_elem == 1 && front[1].ns_per_elem == 3 &&
+           front[2].ns_per_elem == 5);
+    assert(select_config(front, 1)->ns_per_elem == 5);
+    assert(select_config(front, 2.5)->ns_per_elem == 3);
+    assert(select_config(front, 1000)->ns_per_elem == 1 && !select_config(front, 0.1));
+}
+
+int usage() {
+    fprintf(stderr, "usage: tune [--budget ulps] [--exhaustive] [--header path]\n");
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    double budget = 1;
+    bool exhaustive = false;
+    const char *header = nullptr;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--budget" && i + 1 < argc) {
+            budget = atof(argv[++i]);
+        } else if (arg == "--exhaustive") {
+            exhaustive = true;
+        } else if (arg == "--header" && i + 1 < argc) {
+            header = argv[++i];
+        } else {
+            return usage();
+        }
+    }
+    check();
+    // SIGINT cancels the scans, and the tuning stops without a result.
+    cancel_verifiers_on_sigint();
+
+    uint64_t count = exhaustive ? 0 : 1 << 22;
+    // The positive normal floats, and the positive and the negative halves of
+    // [-87 .. 88].
+    std::vector<float> log_iv = generate_test_vector<float>(0.001, 1000, 10000);
+    std::vector<Config> log_front = tune("log", log_configs(), reference_log,
+                                         { { 0x00800000, 0x7f800000 } }, count, log_iv);
+    std::vector<float> exp_iv = generate_test_vector<float>(-87, 88, 10000);
+    std::vector<Config> exp_front =
+        tune("exp", exp_configs(), reference_exp,
+             { { 0x00000000, 0x42b00001 }, { 0x80000000, 0xc2ae0001 } }, count, exp_iv);
+
+    if (log_front.empty() || exp_front.empty()) {
+        fprintf(stderr, "error: the error measurements were cancelled\n");
+        return 1;
+    }
+    const Config *log_winner = select_config(log_front, budget);
+    const Config *exp_winner = select_config(exp_front, budget);
+    if (!log_winner || !exp_winner) {
+        fprintf(stderr, "error: no configuration of %s is within %g ULP\n",
+                log_winner ? "exp" : "log", budget);
+        return 1;
+    }
+    printf("\nWithin %g ULP: tuned_log = %s, tuned_exp = %s\n", budget, log_winner->name,
+           exp_winner->name);
+
+    if (!header) {
+        return 0;
+    }
+    FILE *out = fopen(header, "w");
+    if (!out) {
+        fprintf(stderr, "error: can't write %s: %s\n", header, strerror(errno));
+        return 1;
+    }
+    write_header(out, budget, *log_winner, *exp_winner);
+    fclose(out);
+    printf("Wrote %s\n", header);
+    return 0;
+}
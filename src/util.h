@@ -1,15 +1,39 @@
+#ifndef UTIL_H
+#define UTIL_H
+
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <random>
 #include <string>
 #include <thread>
+#include <unistd.h>
 #include <vector>
 
+#include "double_double.h"
+
 using std::chrono::duration;
 using std::chrono::duration_cast;
 using std::chrono::high_resolution_clock;
 using std::chrono::milliseconds;
 
+// The entry points of the kernels are inline, so that the call sites inline
+// them, and vectorize the loops around them. The benchmarks here measure the
+// cost of a call, and are built with NOINLINE_KERNELS, which keeps the entry
+// points out of line.
+#ifdef NOINLINE_KERNELS
+#define KERNEL_API inline __attribute__((noinline))
+#else
+#define KERNEL_API inline
+#endif
+
 #define PRINT_DOUBLE(name, x)                                                                      \
     {                                                                                              \
         uint64_t ux = bit_cast<uint64_t, double>(x);                                               \
@@ -31,6 +55,32 @@ template <class To, class From> To bit_cast(const From &src) noexcept {
     return dst;
 }
 
+/// @return True if \p a and \p b have the same bits. Unlike ==, this tells
+/// -0 from +0, and compares NaNs by their payloads.
+template <class FloatTy> bool same_bits(FloatTy a, FloatTy b) {
+    return std::memcmp(&a, &b, sizeof(FloatTy)) == 0;
+}
+
+/// @return True if \p x is a NAN.
+inline bool is_nan(float x) {
+    unsigned xb = bit_cast<unsigned, float>(x);
+    xb >>= 23;
+    return (xb & 0xff) == 0xff;
+}
+
+/// @return \p a where \p mask is set, and \p b elsewhere. The selects on
+/// integer masks keep GCC from turning the blends into branches.
+inline float blend(uint32_t mask, float a, float b) {
+    uint32_t ab = bit_cast<uint32_t, float>(a);
+    uint32_t bb = bit_cast<uint32_t, float>(b);
+    return bit_cast<float, uint32_t>((ab & mask) | (bb & ~mask));
+}
+inline double blend(uint64_t mask, double a, double b) {
+    uint64_t ab = bit_cast<uint64_t, double>(a);
+    uint64_t bb = bit_cast<uint64_t, double>(b);
+    return bit_cast<double, uint64_t>((ab & mask) | (bb & ~mask));
+}
+
 // Return the bitwise distance between the two doubles.
 // Notice that a change in sign will return a high ULP difference,
 // which is desirable.
@@ -45,6 +95,25 @@ template <class UnsignedTy, class FloatTy> UnsignedTy ulp_difference(FloatTy n1,
     return (b1 > b2) ? (b1 - b2) : (b2 - b1);
 }
 
+/// @return the distance between \p y and the exact result \p ref, in ULPs of
+/// the result, as a fraction. A correctly rounded \p y is within 0.5 ULP.
+template <class FloatTy> double ulp_error(FloatTy y, DoubleDouble ref) {
+    if (std::isnan(y) || std::isnan(ref.hi)) {
+        return std::isnan(y) && std::isnan(ref.hi) ? 0 : INFINITY;
+    }
+    // The results that overflow the type are exact if they round to inf.
+    if (std::isinf(y) || std::isinf(FloatTy(ref.hi))) {
+        return y == FloatTy(ref.hi) ? 0 : INFINITY;
+    }
+    // The ULP of the result. The denormals share the ULP of the smallest
+    // normal number.
+    constexpr int min_exp = std::numeric_limits<FloatTy>::min_exponent - 1;
+    constexpr int digits = std::numeric_limits<FloatTy>::digits;
+    int e = ref.hi == 0 ? min_exp : std::max(std::ilogb(ref.hi), min_exp);
+    double diff = (double(y) - ref.hi) - ref.lo;
+    return std::abs(std::ldexp(diff, digits - 1 - e));
+}
+
 /// A generic histogram class.
 template <unsigned NumBins> struct Histogram {
     uint64_t payload_[NumBins];
@@ -64,10 +133,10 @@ template <unsigned NumBins> struct Histogram {
         payload_[idx] += val;
     }
 
-    void dump(const char *message) {
+    void dump(const char *message, uint64_t total = 1LL << 32) {
         printf("%s", message);
         for (unsigned i = 0; i < NumBins; i++) {
-            double percent = 100 * double(payload_[i]) / double(1LL << 32);
+            double percent = 100 * double(payload_[i]) / double(total);
             if (i < (NumBins - 1)) {
                 printf("%02d) %02.3f%% - %08lu\n", i, percent, payload_[i]);
             } else {
@@ -77,55 +146,478 @@ template <unsigned NumBins> struct Histogram {
     };
 };
 
+/// Set by the SIGINT handler of cancel_verifiers_on_sigint(), and checked by
+/// the workers of every Verifier. It stays set, so the scans that start after
+/// the interrupt return at once, as cancelled.
+inline std::atomic<bool> verifier_interrupted{ false };
+
+/// Make SIGINT cancel the running Verifier scans, and not kill the program,
+/// so that an interrupted sampling run writes its checkpoint.
+inline void cancel_verifiers_on_sigint() {
+    std::signal(SIGINT, [](int) { verifier_interrupted.store(true, std::memory_order_relaxed); });
+}
+
+/// @return the 64-bit mix of \p x, from splitmix64. Consecutive values of
+/// \p x give independent random numbers, so the sample i of a scan is
+/// random_bits(i), and a resumed scan continues the same sequence.
+inline uint64_t random_bits(uint64_t x) {
+    x += 0x9e3779b97f4a7c15;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
+
+/// Lock-free progress counters of a multi-threaded scan. The workers add the
+/// values that they finished after each block, and the main thread reads the
+/// counter while it waits for them, and reports the rate and the ETA.
+class ScanProgress {
+    std::atomic<uint64_t> done_{ 0 };
+    std::atomic<unsigned> running_{ 0 };
+    uint64_t total_ = 0;
+    // The values that were done before the start, by a resumed scan.
+    uint64_t resumed_ = 0;
+    bool report_ = false;
+    std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point last_report_ = start_;
+
+    void print(const char *end) {
+        double seconds = duration<double>(std::chrono::steady_clock::now() - start_).count();
+        uint64_t done = done_.load(std::memory_order_relaxed);
+        double rate = (done - resumed_) / std::max(seconds, 1e-9);
+        fprintf(stderr, "\r%5.1f%% of %.3g values, %.3g values/s", 100. * done / total_,
+                double(total_), rate);
+        if (*end) {
+            fprintf(stderr, ", in %.1f s%s", seconds, end);
+        } else {
+            fprintf(stderr, ", ETA %.0f s   ", (total_ - done) / std::max(rate, 1e-9));
+        }
+    }
+
+  public:
+    /// Start a scan of \p total values, of which \p resumed are done, and
+    /// report the progress to stderr once a second if \p report.
+    ScanProgress(uint64_t total, uint64_t resumed, bool report)
+        : done_(resumed), total_(total), resumed_(resumed), report_(report) {}
+
+    void add(uint64_t n) { done_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t done() const { return done_.load(std::memory_order_relaxed); }
+
+    /// Run \p scan(tid) on the threads \p threads, and wait for them. Sets
+    /// \p stop when \p stop_after seconds pass since the start of the wait.
+    template <class Scan, unsigned NumThreads>
+    void run(std::thread (&threads)[NumThreads], const Scan &scan, std::atomic<bool> &stop,
+             double stop_after = INFINITY) {
+        auto begin = std::chrono::steady_clock::now();
+        running_.store(NumThreads, std::memory_order_relaxed);
+        for (unsigned i = 0; i < NumThreads; i++) {
+            threads[i] = std::thread([&, i] {
+                scan(i);
+                running_.fetch_sub(1, std::memory_order_release);
+            });
+        }
+        // Poll with a short sleep first, so the short scans don't wait long.
+        auto poll = std::chrono::milliseconds(1);
+        while (running_.load(std::memory_order_acquire)) {
+            std::this_thread::sleep_for(poll);
+            poll = std::min(poll * 2, std::chrono::milliseconds(50));
+            auto now = std::chrono::steady_clock::now();
+            if (report_ && now - last_report_ >= std::chrono::seconds(1)) {
+                last_report_ = now;
+                print("");
+            }
+            if (duration<double>(now - begin).count() >= stop_after) {
+                stop.store(true, std::memory_order_relaxed);
+            }
+        }
+        for (unsigned i = 0; i < NumThreads; i++) {
+            threads[i].join();
+        }
+    }
+
+    /// Print the final rate, if the scan reported its progress.
+    void finish() {
+        if (report_ && last_report_ != start_) {
+            print("\n");
+        }
+    }
+};
+
 /// A helper class that performs multi-threaded computation of ULP differences
 /// between two implementations.
+///
+/// The long scans report their progress to stderr when it is a terminal (see
+/// set_progress()), and stop early on cancel(). The runs of ulp_errors(),
+/// such as the long samplings of the double kernels, can write a checkpoint,
+/// and resume from it (see set_checkpoint()).
 template <class FloatTy = float, class UnsignedTy = unsigned, unsigned NumThreads = 8,
           unsigned NumBins = 32>
 class Verifier {
+    /// The state of a worker. Each worker updates its own state for every
+    /// value, so the states are on separate cache lines.
+    struct alignas(64) Worker {
+        Histogram<NumBins> hist;
+        // The number of values that the worker finished in the current scan,
+        // and its max error.
+        uint64_t done = 0;
+        double max_err = 0;
+        FloatTy max_at = 0;
+    };
+
+    /// The header of a checkpoint, which identifies the run. It has no
+    /// padding, so it compares with memcmp.
+    struct CheckpointHeader {
+        char magic[8] = { 'V', 'E', 'R', 'I', 'F', 'Y', '1', 0 };
+        uint64_t first, last, count;
+        uint32_t threads = NumThreads, bins = NumBins, float_size = sizeof(FloatTy), unused = 0;
+    };
+
     std::thread threads_[NumThreads];
-    Histogram<NumBins> hist_[NumThreads];
+    Worker workers_[NumThreads];
+    std::atomic<bool> cancel_{ false };
+    // Set to stop the workers at the end of the current block.
+    std::atomic<bool> stop_{ false };
+    bool progress_ = isatty(fileno(stderr));
+    std::string checkpoint_;
+    double checkpoint_seconds_ = 60;
+
+    /// @return True if the workers should stop at the end of the block.
+    bool should_stop() const {
+        return stop_.load(std::memory_order_relaxed) || cancelled();
+    }
+
+    /// Write the states of the workers, after \p header, to the checkpoint.
+    /// The file is written next to the checkpoint, and then renamed over it,
+    /// so a crash leaves the previous checkpoint intact.
+    void save_checkpoint(const CheckpointHeader &header) const {
+        std::string tmp = checkpoint_ + ".tmp";
+        FILE *f = fopen(tmp.c_str(), "wb");
+        if (!f) {
+            fprintf(stderr, "warning: can't write the checkpoint %s\n", tmp.c_str());
+            return;
+        }
+        fwrite(&header, sizeof(header), 1, f);
+        for (const Worker &w : workers_) {
+            fwrite(&w, sizeof(Worker), 1, f);
+        }
+        if (fclose(f) == 0) {
+            std::rename(tmp.c_str(), checkpoint_.c_str());
+        }
+    }
+
+    /// Load the states of the workers from the checkpoint, if it exists and
+    /// it is of the run \p header.
+    /// @return True if the states were loaded.
+    bool load_checkpoint(const CheckpointHeader &header) {
+        FILE *f = checkpoint_.empty() ? nullptr : fopen(checkpoint_.c_str(), "rb");
+        if (!f) {
+            return false;
+        }
+        CheckpointHeader saved;
+        Worker workers[NumThreads];
+        bool ok = fread(&saved, sizeof(saved), 1, f) == 1 &&
+                  memcmp(&saved, &header, sizeof(header)) == 0 &&
+                  fread(workers, sizeof(Worker), NumThreads, f) == NumThreads;
+        fclose(f);
+        if (!ok) {
+            fprintf(stderr, "warning: ignoring the checkpoint %s of another run\n",
+                    checkpoint_.c_str());
+            return false;
+        }
+        std::copy(workers, workers + NumThreads, workers_);
+        return true;
+    }
+
+    /// Clear the cancel and the stop flags, and the states of the workers,
+    /// which a Verifier keeps from its previous scan. A checkpointed scan can
+    /// end with stop_ set, when the poll after its last block stops it.
+    void start_scan() {
+        cancel_.store(false, std::memory_order_relaxed);
+        stop_.store(false, std::memory_order_relaxed);
+        for (Worker &w : workers_) {
+            w = Worker();
+        }
+    }
+
+    /// Print a note if the scan was cancelled after \p done of its \p total
+    /// values.
+    /// @return True if the scan was cancelled.
+    static bool print_cancelled(uint64_t done, uint64_t total) {
+        if (done == total) {
+            return false;
+        }
+        printf("\nCancelled after %lu of %lu values, the results are partial\n",
+               (unsigned long)done, (unsigned long)total);
+        return true;
+    }
 
   public:
-    void print_ulp_deltas(FloatTy (*handle1)(FloatTy), FloatTy (*handle2)(FloatTy)) {
-        auto scan = [&handle1, &handle2](uint64_t start, uint64_t end, Histogram<NumBins> &hist) {
-            // For each value in the 32bit range.
-            for (uint64_t i = start; i < end; i++) {
-                FloatTy val = bit_cast<FloatTy, UnsignedTy>((unsigned)i);
-                FloatTy r1 = handle1(val);
-                FloatTy r2 = handle2(val);
-                // Record the ULP delta.
-                unsigned ud = ulp_difference<UnsignedTy, FloatTy>(r1, r2);
-                hist.add(ud);
+    /// Report the progress of the scans to stderr once a second. The default
+    /// is to report when stderr is a terminal.
+    void set_progress(bool enable) { progress_ = enable; }
+
+    /// Write the state of the runs of ulp_errors() to \p path every
+    /// \p seconds, and when the run is cancelled. A run with the same
+    /// arguments resumes from the checkpoint, and removes it when it
+    /// completes. The header of the checkpoint records the range, the count
+    /// and the shape of the Verifier, but not the functions, so a checkpoint
+    /// is only for the same command.
+    void set_checkpoint(const std::string &path, double seconds = 60) {
+        checkpoint_ = path;
+        checkpoint_seconds_ = seconds;
+    }
+
+    /// Stop the running scan at the end of the current block of each worker.
+    /// The scan returns the partial results. This is safe to call from
+    /// another thread, or from a signal handler. Each scan clears the flag
+    /// when it starts, so cancel() only stops the scan that is running.
+    void cancel() { cancel_.store(true, std::memory_order_relaxed); }
+    bool cancelled() const {
+        return cancel_.load(std::memory_order_relaxed) ||
+               verifier_interrupted.load(std::memory_order_relaxed);
+    }
+
+    /// Compare \p handle1 and \p handle2 on the bit patterns in the range
+    /// [first .. last). The default range covers all 32-bit values.
+    void print_ulp_deltas(FloatTy (*handle1)(FloatTy), FloatTy (*handle2)(FloatTy),
+                          uint64_t first = 0, uint64_t last = 1LL << 32) {
+        // The workers add to the progress counter once per block.
+        constexpr uint64_t BlockSize = 1 << 16;
+        start_scan();
+        ScanProgress progress(last - first, 0, progress_);
+        uint64_t chunk_size = (last - first + NumThreads - 1) / NumThreads;
+        auto scan = [&](unsigned tid) {
+            Histogram<NumBins> &hist = workers_[tid].hist;
+            uint64_t start = std::min(last, first + tid * chunk_size);
+            uint64_t end = std::min(last, first + (tid + 1) * chunk_size);
+            while (start < end && !should_stop()) {
+                uint64_t block_end = std::min(end, start + BlockSize);
+                // For each value in the 32bit range.
+                for (uint64_t i = start; i < block_end; i++) {
+                    FloatTy val = bit_cast<FloatTy, UnsignedTy>((unsigned)i);
+                    FloatTy r1 = handle1(val);
+                    FloatTy r2 = handle2(val);
+                    // Record the ULP delta.
+                    unsigned ud = ulp_difference<UnsignedTy, FloatTy>(r1, r2);
+                    hist.add(ud);
+                }
+                progress.add(block_end - start);
+                start = block_end;
             }
         };
-
-        uint64_t chunk_size = (1L << 32) / NumThreads;
-        for (unsigned i = 0; i < NumThreads; i++) {
-            uint64_t start = i * chunk_size;
-            uint64_t end = (i + 1) * chunk_size;
-            threads_[i] = std::thread(scan, start, end, std::ref(hist_[i]));
+        progress.run(threads_, scan, stop_);
+        progress.finish();
+        // Merge the histograms after the workers finished.
+        for (unsigned i = 1; i < NumThreads; i++) {
+            workers_[0].hist.join(workers_[i].hist);
         }
-        for (unsigned i = 0; i < NumThreads; i++) {
-            threads_[i].join();
+        // Report the histogram.
+        if (progress.done()) {
+            workers_[0].hist.dump("\nULP delta:\n", progress.done());
         }
+        print_cancelled(progress.done(), last - first);
+    }
+
+    /// Compare the binary functions \p handle1 and \p handle2 on every pair
+    /// of points of a \p steps x \p steps grid that covers [start .. end].
+    void print_ulp_deltas(FloatTy (*handle1)(FloatTy, FloatTy), FloatTy (*handle2)(FloatTy, FloatTy),
+                          FloatTy start, FloatTy end, uint64_t steps) {
+        start_scan();
+        ScanProgress progress(steps * steps, 0, progress_);
+        uint64_t chunk_size = (steps + NumThreads - 1) / NumThreads;
+        auto scan = [&](unsigned tid) {
+            Histogram<NumBins> &hist = workers_[tid].hist;
+            uint64_t first_row = std::min<uint64_t>(steps, tid * chunk_size);
+            uint64_t last_row = std::min<uint64_t>(steps, (tid + 1) * chunk_size);
+            for (uint64_t i = first_row; i < last_row && !should_stop(); i++) {
+                FloatTy a = start + ((end - start) * i) / (steps - 1);
+                for (uint64_t j = 0; j < steps; j++) {
+                    FloatTy b = start + ((end - start) * j) / (steps - 1);
+                    FloatTy r1 = handle1(a, b);
+                    FloatTy r2 = handle2(a, b);
+                    // Record the ULP delta.
+                    unsigned ud = ulp_difference<UnsignedTy, FloatTy>(r1, r2);
+                    hist.add(ud);
+                }
+                progress.add(steps);
+            }
+        };
+        progress.run(threads_, scan, stop_);
+        progress.finish();
         // Merge the histograms after the workers finished.
         for (unsigned i = 1; i < NumThreads; i++) {
-            hist_[0].join(hist_[i]);
+            workers_[0].hist.join(workers_[i].hist);
         }
         // Report the histogram.
-        hist_[0].dump("\nULP delta:\n");
+        if (progress.done()) {
+            workers_[0].hist.dump("\nULP delta:\n", progress.done());
+        }
+        print_cancelled(progress.done(), steps * steps);
+    }
+
+    /// Compare \p handle to the batch reference \p ref, which computes the
+    /// exact results as double-double values, on \p count random bit patterns
+    /// in the range [first .. last), or on every pattern if \p count is zero.
+    /// Collects the histogram of the ULP errors, and sets \p max_input to the
+    /// input of the max error if it's not null.
+    ///
+    /// With a checkpoint, the workers stop every few seconds to save their
+    /// state, and start again from it.
+    /// @return the max error as a fraction of an ULP, or NaN if the scan was
+    /// cancelled before it finished. The histogram and \p max_input have the
+    /// results of the values that it finished.
+    double ulp_errors(FloatTy (*handle)(FloatTy),
+                      void (*ref)(const FloatTy *, DoubleDouble *, size_t), uint64_t first,
+                      uint64_t last, uint64_t count = 0, FloatTy *max_input = nullptr) {
+        // The reference is called on blocks of inputs, to amortize the call
+        // and to let it vectorize.
+        constexpr unsigned BlockSize = 1024;
+        uint64_t total = count ? count : last - first;
+        uint64_t chunk_size = (total + NumThreads - 1) / NumThreads;
+
+        start_scan();
+        CheckpointHeader header;
+        header.first = first;
+        header.last = last;
+        header.count = count;
+        uint64_t resumed = 0;
+        if (load_checkpoint(header)) {
+            for (const Worker &w : workers_) {
+                resumed += w.done;
+            }
+        }
+
+        ScanProgress progress(total, resumed, progress_);
+        auto scan = [&](unsigned tid) {
+            Worker &w = workers_[tid];
+            uint64_t start = std::min(total, tid * chunk_size);
+            uint64_t num = std::min(total, (tid + 1) * chunk_size) - start;
+            FloatTy in[BlockSize];
+            DoubleDouble out[BlockSize];
+            while (w.done < num && !should_stop()) {
+                unsigned len = std::min<uint64_t>(BlockSize, num - w.done);
+                for (unsigned j = 0; j < len; j++) {
+                    uint64_t i = start + w.done + j;
+                    uint64_t bits = count ? first + random_bits(i) % (last - first) : first + i;
+                    in[j] = bit_cast<FloatTy, UnsignedTy>(UnsignedTy(bits));
+                }
+                ref(in, out, len);
+                for (unsigned j = 0; j < len; j++) {
+                    double err = ulp_error(handle(in[j]), out[j]);
+                    if (err > w.max_err) {
+                        w.max_err = err;
+                        w.max_at = in[j];
+                    }
+                    w.hist.add(unsigned(std::min<double>(err, NumBins)));
+                }
+                w.done += len;
+                progress.add(len);
+            }
+        };
+
+        bool saving = !checkpoint_.empty();
+        while (true) {
+            stop_.store(false, std::memory_order_relaxed);
+            progress.run(threads_, scan, stop_, saving ? checkpoint_seconds_ : INFINITY);
+            if (progress.done() == total) {
+                if (saving) {
+                    std::remove(checkpoint_.c_str());
+                }
+                break;
+            }
+            if (saving) {
+                save_checkpoint(header);
+            }
+            if (cancelled()) {
+                break;
+            }
+        }
+        progress.finish();
+
+        // Merge the histograms and the max errors after the workers finished.
+        for (unsigned i = 1; i < NumThreads; i++) {
+            workers_[0].hist.join(workers_[i].hist);
+            if (workers_[i].max_err > workers_[0].max_err) {
+                workers_[0].max_err = workers_[i].max_err;
+                workers_[0].max_at = workers_[i].max_at;
+            }
+        }
+        if (max_input) {
+            *max_input = workers_[0].max_at;
+        }
+        return progress.done() == total ? workers_[0].max_err : NAN;
+    }
+
+    /// Like ulp_errors(), and prints the histogram of the ULP errors, and the
+    /// max error as a fraction of an ULP. A cancelled scan prints the results
+    /// of the values that it finished, and a note that they are partial.
+    void print_ulp_errors(FloatTy (*handle)(FloatTy),
+                          void (*ref)(const FloatTy *, DoubleDouble *, size_t), uint64_t first,
+                          uint64_t last, uint64_t count = 0) {
+        FloatTy max_at = 0;
+        ulp_errors(handle, ref, first, last, count, &max_at);
+        uint64_t done = 0;
+        for (const Worker &w : workers_) {
+            done += w.done;
+        }
+        if (done) {
+            workers_[0].hist.dump("\nULP error:\n", done);
+        }
+        if (print_cancelled(done, count ? count : last - first)) {
+            if (done) {
+                printf("Max error of the finished values = %.3f ULP at %a\n",
+                       workers_[0].max_err, double(max_at));
+            }
+        } else {
+            printf("Max error = %.3f ULP at %a\n", workers_[0].max_err, double(max_at));
+        }
     }
 };
 
 // Compare two functions and count the number of values with different ULPs.
 // See https://en.wikipedia.org/wiki/IEEE_754#Basic_and_interchange_formats
-void print_ulp_deltas(float (*handle1)(float), float (*handle2)(float)) {
+// The optional range [first .. last) restricts the scan to some bit patterns.
+inline void print_ulp_deltas(float (*handle1)(float), float (*handle2)(float), uint64_t first = 0,
+                      uint64_t last = 1LL << 32) {
+    Verifier<float, unsigned, 64, 16> verifier;
+    verifier.print_ulp_deltas(handle1, handle2, first, last);
+}
+
+// Compare two binary functions on a grid of \p steps x \p steps points in the
+// range [start .. end], and count the number of pairs with different ULPs.
+inline void print_ulp_deltas(float (*handle1)(float, float), float (*handle2)(float, float), float start,
+                      float end, uint64_t steps) {
     Verifier<float, unsigned, 64, 16> verifier;
-    verifier.print_ulp_deltas(handle1, handle2);
+    verifier.print_ulp_deltas(handle1, handle2, start, end, steps);
+}
+
+/// Compare the batch kernel \p batch with the scalar kernel \p handle on all
+/// the floats. The batch runs on blocks of 2^16 consecutive bit patterns, once
+/// into a separate array and once in place.
+/// @return the number of results with different bits, where NaNs with
+/// different payloads are different.
+inline uint64_t count_batch_mismatches(void (*batch)(const float *, float *, size_t),
+                                       float (*handle)(float)) {
+    constexpr size_t BlockSize = 1 << 16;
+    std::vector<float> in(BlockSize), out(BlockSize), in_place(BlockSize);
+    uint64_t mismatches = 0;
+    for (uint64_t first = 0; first < (1ull << 32); first += BlockSize) {
+        for (size_t j = 0; j < BlockSize; j++) {
+            in[j] = bit_cast<float, uint32_t>(uint32_t(first + j));
+        }
+        batch(in.data(), out.data(), BlockSize);
+        in_place = in;
+        batch(in_place.data(), in_place.data(), BlockSize);
+        for (size_t j = 0; j < BlockSize; j++) {
+            float expected = handle(in[j]);
+            mismatches += !same_bits(expected, out[j]);
+            mismatches += !same_bits(expected, in_place[j]);
+        }
+    }
+    return mismatches;
 }
 
 // Prints a lookup table for [0x3fxx0000], that computes f(x)=log(1/x).
-void print_log_recp_table_for_3f_values() {
+inline void print_log_recp_table_for_3f_values() {
     uint64_t table[256] = { 0 };
 
     for (unsigned i = 0; i < 256; i++) {
@@ -147,7 +639,7 @@ void print_log_recp_table_for_3f_values() {
 }
 
 // Prints a lookup table for [0x3fxx0000], that computes f(x)=1/x.
-void print_recp_table_for_3f_values() {
+inline void print_recp_table_for_3f_values() {
     uint64_t table[256] = { 0 };
 
     for (unsigned i = 0; i < 256; i++) {
@@ -202,3 +694,120 @@ void bench(const std::string &name, FloatTy (*handle)(FloatTy), const std::vecto
     std::cout << "sum = " << sum << ", ";
     std::cout << "time = " << ms_int.count() << "ms\n";
 }
+
+/// @brief Benchmark the latency of \p handle. Like bench(), except that each
+/// call depends on the result of the previous call, so the calls can't
+/// overlap in the pipeline.
+template <class FloatTy>
+void bench_latency(const std::string &name, FloatTy (*handle)(FloatTy),
+                   const std::vector<FloatTy> &iv, int iterations = 10000) {
+    auto t1 = high_resolution_clock::now();
+
+    FloatTy sum = 0;
+    FloatTy prev = 0;
+    for (int iter = 0; iter < iterations; iter++) {
+        for (auto elem : iv) {
+            // The difference is zero, but the compiler can't remove it.
+            prev = handle(elem + (prev - prev));
+            sum += prev;
+        }
+    }
+
+    auto t2 = high_resolution_clock::now();
+    auto ms_int = duration_cast<milliseconds>(t2 - t1);
+    std::cout << "name = " << name << ", ";
+    std::cout << "sum = " << sum << ", ";
+    std::cout << "time = " << ms_int.count() << "ms\n";
+}
+
+/// @brief Benchmark the throughput of \p handle. Like bench(), except that
+/// the results are stored to memory, so the calls are independent and
+/// there is no chain of additions that limits the loop.
+template <class FloatTy>
+void bench_throughput(const std::string &name, FloatTy (*handle)(FloatTy),
+                      const std::vector<FloatTy> &iv, int iterations = 10000) {
+    std::vector<FloatTy> out(iv.size());
+    auto t1 = high_resolution_clock::now();
+
+    FloatTy sum = 0;
+    for (int iter = 0; iter < iterations; iter++) {
+        for (size_t i = 0; i < iv.size(); i++) {
+            out[i] = handle(iv[i]);
+        }
+        sum += out[iter % out.size()];
+    }
+
+    auto t2 = high_resolution_clock::now();
+    auto ms_int = duration_cast<milliseconds>(t2 - t1);
+    std::cout << "name = " << name << ", ";
+    std::cout << "sum = " << sum << ", ";
+    std::cout << "time = " << ms_int.count() << "ms\n";
+}
+
+/// @brief Benchmark the batch kernel \p handle, which computes an output for
+/// each input of the array, on the test vector \p iv. Prints the result to
+/// stdout.
+template <class FloatTy>
+void bench_batch(const std::string &name, void (*handle)(const FloatTy *, FloatTy *, size_t),
+                 const std::vector<FloatTy> &iv, int iterations = 10000) {
+    std::vector<FloatTy> out(iv.size());
+    auto t1 = high_resolution_clock::now();
+
+    double sum = 0;
+    for (int iter = 0; iter < iterations; iter++) {
+        handle(iv.data(), out.data(), iv.size());
+        sum += out[iter % out.size()];
+    }
+
+    auto t2 = high_resolution_clock::now();
+    auto ms_int = duration_cast<milliseconds>(t2 - t1);
+    std::cout << "name = " << name << ", ";
+    std::cout << "sum = " << sum << ", ";
+    std::cout << "time = " << ms_int.count() << "ms\n";
+}
+
+/// @brief Like bench_batch, for the double-double kernels, which write the
+/// high and the low parts of the outputs to two arrays.
+template <class FloatTy>
+void bench_batch(const std::string &name,
+                 void (*handle)(const FloatTy *, FloatTy *, FloatTy *, size_t),
+                 const std::vector<FloatTy> &iv, int iterations = 10000) {
+    std::vector<FloatTy> hi(iv.size()), lo(iv.size());
+    auto t1 = high_resolution_clock::now();
+
+    double sum = 0;
+    for (int iter = 0; iter < iterations; iter++) {
+        handle(iv.data(), hi.data(), lo.data(), iv.size());
+        sum += hi[iter % hi.size()];
+    }
+
+    auto t2 = high_resolution_clock::now();
+    auto ms_int = duration_cast<milliseconds>(t2 - t1);
+    std::cout << "name = " << name << ", ";
+    std::cout << "sum = " << sum << ", ";
+    std::cout << "time = " << ms_int.count() << "ms\n";
+}
+
+/// @brief Benchmark the binary function \p handle on the pairs of inputs from
+/// the test vectors \p iv1 and \p iv2. Prints the result to stdout.
+template <class FloatTy>
+void bench(const std::string &name, FloatTy (*handle)(FloatTy, FloatTy),
+           const std::vector<FloatTy> &iv1, const std::vector<FloatTy> &iv2,
+           int iterations = 10000) {
+    auto t1 = high_resolution_clock::now();
+
+    FloatTy sum = 0;
+    for (int iter = 0; iter < iterations; iter++) {
+        for (size_t i = 0; i < iv1.size(); i++) {
+            sum += handle(iv1[i], iv2[i]);
+        }
+    }
+
+    auto t2 = high_resolution_clock::now();
+    auto ms_int = duration_cast<milliseconds>(t2 - t1);
+    std::cout << "name = " << name << ", ";
+    std::cout << "sum = " << sum << ", ";
+    std::cout << "time = " << ms_int.count() << "ms\n";
+}
+
+#endif // UTIL_H
@@ -0,0 +1,144 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <math.h>
+#include <string>
+#include <vector>
+
+#include "vector_math.h"
+#include "exp_accurate.h"
+#include "log_accurate.h"
+#include "util.h"
+#include "vector_abi.h"
+
+// The loops below are plain loops of logf and expf. This file is compiled
+// with -fno-math-errno, and vector_math.h declares the functions as SIMD, so
+// GCC vectorizes the loops into calls to the variant of the target of the
+// loop (see objdump -d): the SSE2 variants for the baseline x86-64 target of
+// this file, and the AVX and AVX-512 variants for the loops with a target
+// attribute. The AVX2 loops are in vector_abi_avx2.cc, which is compiled with
+// -mavx2 -mfma. The variants are only called from the loops, because a caller
+// with a narrower target passes the wide vectors in memory.
+
+void __attribute__((noinline)) loop_logf(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = logf(in[i]);
+    }
+}
+
+void __attribute__((noinline)) loop_expf(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = expf(in[i]);
+    }
+}
+
+__attribute__((noinline, target("avx"))) void loop_logf_avx(const float *in, float *out,
+                                                             size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = logf(in[i]);
+    }
+}
+
+__attribute__((noinline, target("avx"))) void loop_expf_avx(const float *in, float *out,
+                                                             size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = expf(in[i]);
+    }
+}
+
+__attribute__((noinline, target("avx512f"))) void loop_logf_avx512(const float *in, float *out,
+                                                                    size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = logf(in[i]);
+    }
+}
+
+__attribute__((noinline, target("avx512f"))) void loop_expf_avx512(const float *in, float *out,
+                                                                    size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = expf(in[i]);
+    }
+}
+
+// Defined in vector_abi_avx2.cc.
+void loop_logf_avx2(const float *in, float *out, size_t n);
+void loop_expf_avx2(const float *in, float *out, size_t n);
+
+/// The loops of one ISA, and whether this machine supports it.
+struct VectorLoops {
+    const char *isa;
+    bool supported;
+    void (*logf)(const float *, float *, size_t);
+    void (*expf)(const float *, float *, size_t);
+};
+
+const VectorLoops vector_loops[] = {
+    { "SSE2", true, loop_logf, loop_expf },
+    { "AVX", __builtin_cpu_supports("avx") != 0, loop_logf_avx, loop_expf_avx },
+    { "AVX2", __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"), loop_logf_avx2,
+      loop_expf_avx2 },
+    { "AVX-512", __builtin_cpu_supports("avx512f") != 0, loop_logf_avx512, loop_expf_avx512 },
+};
+
+// The same loops through a call that GCC can't vectorize, which is the cost
+// of the scalar libm functions.
+float __attribute__((noinline)) libm_logf(float x) { return logf(x); }
+float __attribute__((noinline)) libm_expf(float x) { return expf(x); }
+
+void __attribute__((noinline)) loop_libm_logf(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = libm_logf(in[i]);
+    }
+}
+
+void __attribute__((noinline)) loop_libm_expf(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = libm_expf(in[i]);
+    }
+}
+
+void check() {
+    // The special values, and other inputs up to a multiple of all the vector
+    // lengths, so that the loops don't call the scalar logf and expf of libm.
+    float inf = INFINITY;
+    std::vector<float> x = { 1,     0,      -0.f,  -1,    inf,   -inf, NAN,  0x1p-149f,
+                             0x1p-127f, 2,   100,   1e-30f, 88.7f, -104, -87.5f, 1e30f,
+                             0x1p-140f, 3,   -2,    50,    7,     1e-3f, 1e3f, -1e-30f,
+                             0.5f,  -88.f,  89.f,  1e-40f, 0x1p126f, 42,  -0.1f, 1.5f };
+    std::vector<float> l(x.size()), e(x.size());
+    for (const VectorLoops &loops : vector_loops) {
+        if (!loops.supported) {
+            continue;
+        }
+        loops.logf(x.data(), l.data(), x.size());
+        loops.expf(x.data(), e.data(), x.size());
+        for (size_t i = 0; i < x.size(); i++) {
+            assert(same_bits(l[i], my_log(x[i])) && same_bits(e[i], my_exp(x[i])));
+        }
+        assert(l[1] == -inf && l[2] == -inf && std::isnan(l[3]) && l[4] == inf);
+        assert(std::isnan(l[6]) && e[4] == inf && e[5] == 0 && std::isnan(e[6]));
+        assert(e[13] == 0 && e[15] == inf);
+    }
+}
+
+int main(int argc, char **argv) {
+    check();
+    std::vector<float> iv = generate_test_vector<float>(0.01, 1000., 10000);
+    std::vector<float> ev = generate_test_vector<float>(-20, 20, 10000);
+    for (const VectorLoops &loops : vector_loops) {
+        if (!loops.supported) {
+            continue;
+        }
+        // The blocks are a multiple of the vector length, so the loops don't
+        // call the scalar logf and expf of libm for the remainder.
+        printf("Mismatches, %s: logf = %lu, expf = %lu\n", loops.isa,
+               count_batch_mismatches(loops.logf, my_log),
+               count_batch_mismatches(loops.expf, my_exp));
+        std::string isa = std::string(" (") + loops.isa + ")";
+        bench_batch("vector_logf" + isa, loops.logf, iv);
+        bench_batch("vector_expf" + isa, loops.expf, ev);
+    }
+    bench_batch("libm_logf", loop_libm_logf, iv);
+    bench_batch("libm_expf", loop_libm_expf, ev);
+    return 0;
+}
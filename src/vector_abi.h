@@ -0,0 +1,105 @@
+#ifndef VECTOR_ABI_H
+#define VECTOR_ABI_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "domain.h"
+#include "exp_accurate.h"
+#include "log_accurate.h"
+#include "util.h"
+
+// The vector variants of logf and expf, under the names of the x86_64 vector
+// function ABI, that GCC calls from the loops that it vectorizes (see
+// vector_math.h). The name encodes the ISA (b = SSE, c = AVX, d = AVX2,
+// e = AVX-512), the mask (N = unmasked), the number of lanes, and the kind of
+// the argument (v = vector). Include this header in exactly one translation
+// unit of the program.
+//
+// Each variant runs a branch-free version of the scalar kernel on every lane:
+// the special values are computed like the other lanes, and are replaced with
+// a select at the end. The lanes loop vectorizes, so each variant is a single
+// pass of vector instructions with gathers for the tables. The log variants
+// return the results of my_log, and the exp variants return the results of
+// my_exp, for all the inputs.
+//
+// Each variant is compiled for the ISA of its name, with a target attribute,
+// so that a program that selects the AVX2 variant runs on a machine without
+// AVX-512. The ISA of the b variants is the baseline SSE2. SSE2 and AVX have
+// no FMA instruction, so the b and c variants call fma of libm, and their
+// lanes loops don't vectorize. Compile the translation unit without
+// -march=native: GCC does not inline the kernels into the variants when they
+// are compiled for a wider ISA, and the variants would call the wide kernels.
+
+typedef float vec4f __attribute__((vector_size(16)));
+typedef float vec8f __attribute__((vector_size(32)));
+typedef float vec16f __attribute__((vector_size(64)));
+
+/// Compute log(x) without branches.
+inline __attribute__((always_inline)) float log_lane(float x) {
+    // Scale the denormals to normal floats, like reduce_fp32 does.
+    uint32_t bits = bit_cast<uint32_t, float>(x);
+    uint32_t denormal = -uint32_t(bits < 0x800000);
+    uint32_t sbits = bit_cast<uint32_t, float>(blend(denormal, x * 0x1p32f, x));
+    float m = bit_cast<float, uint32_t>((sbits & 0x7FFFFF) | 0x3f800000);
+    int E = int((sbits >> 23) & 0xff) - 127 - int(denormal & 32);
+    float r = log_of_reduced(m, E);
+
+    // Replace the special values. -Inf is negative, so the blend of the
+    // negative values comes last.
+    r = blend(-uint32_t((bits & 0x7f800000) == 0x7f800000), x, r);
+    r = blend(-uint32_t(x == 0), bit_cast<float, unsigned>(0xff800000), r); // -Inf
+    return blend(-uint32_t(x < 0), bit_cast<float, unsigned>(0xffc00000), r); // -Nan.
+}
+
+/// Compute exp(x) without branches.
+inline __attribute__((always_inline)) float exp_lane(float x) {
+    // Clamp x to the range of the table. exp(-104) rounds to zero and exp(89)
+    // rounds to infinity, like all the values beyond them. NaN is mapped to
+    // -104, and restored at the end.
+    float c = blend(-uint32_t(x > -104.f), x, -104.f);
+    c = blend(-uint32_t(c < 89.f), c, 89.f);
+    float r = my_exp_in<ExpTableRange>(c);
+    return blend(-uint32_t(x != x), x, r);
+}
+
+/// Apply \p Kernel to each lane of \p x, and write the results to \p res.
+/// The vectors are passed by reference, which has the same ABI on all the
+/// targets of the variants.
+template <float (*Kernel)(float), class VecTy>
+inline __attribute__((always_inline)) void apply_lanes(const VecTy &x, VecTy &res) {
+    constexpr size_t Lanes = sizeof(VecTy) / sizeof(float);
+    float in[Lanes], out[Lanes];
+    memcpy(in, &x, sizeof(VecTy));
+    for (size_t i = 0; i < Lanes; i++) {
+        out[i] = Kernel(in[i]);
+    }
+    memcpy(&res, out, sizeof(VecTy));
+}
+
+// Define the variant \p name for the ISA \p isa, which applies \p kernel to
+// each lane of a VecTy.
+#define VECTOR_VARIANT(isa, VecTy, name, kernel)                                                  \
+    __attribute__((target(isa))) VecTy name(VecTy x) {                                             \
+        VecTy res;                                                                                 \
+        apply_lanes<kernel>(x, res);                                                               \
+        return res;                                                                                \
+    }
+
+extern "C" {
+VECTOR_VARIANT("sse2", vec4f, _ZGVbN4v_logf, log_lane)
+VECTOR_VARIANT("avx", vec8f, _ZGVcN8v_logf, log_lane)
+VECTOR_VARIANT("avx2,fma", vec8f, _ZGVdN8v_logf, log_lane)
+VECTOR_VARIANT("avx512f", vec16f, _ZGVeN16v_logf, log_lane)
+
+VECTOR_VARIANT("sse2", vec4f, _ZGVbN4v_expf, exp_lane)
+VECTOR_VARIANT("avx", vec8f, _ZGVcN8v_expf, exp_lane)
+VECTOR_VARIANT("avx2,fma", vec8f, _ZGVdN8v_expf, exp_lane)
+VECTOR_VARIANT("avx512f", vec16f, _ZGVeN16v_expf, exp_lane)
+}
+
+#undef VECTOR_VARIANT
+
+#endif // VECTOR_ABI_H
@@ -0,0 +1,20 @@
+#include <cstddef>
+
+#include "vector_math.h"
+
+// The loops of vector_abi.cc, in a translation unit that is compiled with
+// -mavx2 -mfma, the ISA of the "avx2,fma" variants of vector_abi.h, and
+// without -march=native, like the programs that are built for AVX2 machines. GCC vectorizes the loops into calls to _ZGVdN8v_logf and
+// _ZGVdN8v_expf, which must not contain AVX-512 instructions.
+
+void loop_logf_avx2(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = logf(in[i]);
+    }
+}
+
+void loop_expf_avx2(const float *in, float *out, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = expf(in[i]);
+    }
+}
@@ -0,0 +1,24 @@
+#ifndef VECTOR_MATH_H
+#define VECTOR_MATH_H
+
+#include <math.h>
+
+// Declares logf and expf as SIMD functions with the x86_64 vector function
+// ABI, which lets GCC vectorize the loops that call them: a loop of logf on
+// AVX-512 calls _ZGVeN16v_logf on 16 floats, and the scalar logf on the
+// remainder. The vector variants are defined in vector_abi.h, on top of
+// my_log and my_exp, and they interpose the variants of libmvec.
+//
+// Include this header in the translation units with the loops, and compile
+// them with -fno-math-errno, because the vector variants don't set errno.
+// With -ffast-math, glibc already declares these functions in
+// <bits/math-vector.h>, and the loops call the same names without this header.
+// The kernels themselves must not be compiled with -ffast-math, which would
+// remove their checks for NaN.
+
+extern "C" {
+__attribute__((simd("notinbranch"))) float logf(float) noexcept;
+__attribute__((simd("notinbranch"))) float expf(float) noexcept;
+}
+
+#endif // VECTOR_MATH_H